@@ -1,4 +1,5 @@
-//g++ -std=c++11 15.cpp -O3 -pedantic -Wall -Wextra
+//g++ -std=c++11 15puzzle.cpp -O3 -pedantic -Wall -Wextra -Dmainfake=main (or make fifteen)
+//./fifteen.exe <height> <width> <dfs|ida|pdb> <663|78>    or    ./fifteen.exe bench <count> <663|78>
 #include <tuple>
 #include <set>
 #include <vector>
@@ -8,15 +9,307 @@
 #include <limits>
 #include <map> //multimap
 #include <cmath>        // std::abs
+#include <cstdint>
+#include <cstdlib>      // std::atoi
+#include <string>
+#include <algorithm>
+#include <bitset>
+#include <fstream>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <sys/mman.h>   // pattern databases are memory mapped (POSIX)
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "search.h"
 
 enum Direction { up, right, down, left };
 
+// order the packed searches try the moves in, same as PossibleMoves
+Direction const move_order[4] = { down, right, up, left };
+
+////////////////////////////////////////////////////////////////////////////////
+// Additive pattern database of the 4x4 board. For every placement of the pattern
+// tiles it has the fewest moves of pattern tiles that take them home; the other
+// tiles are all alike and moving them is free, so disjoint patterns add up.
+// One byte per placement, indexed by the rank of the placement. Built by a
+// multi-threaded breadth-first search back from the goal the first time, saved to
+// a file and memory mapped from then on.
+class PatternDatabase {
+	std::vector<int> tiles;
+	size_t entries = 0;                      // 16 * 15 * ... one per placement
+	unsigned char const * values = nullptr;  // inside the mapping
+	void * mapping = nullptr;
+	size_t mapping_size = 0;
+public:
+	////////////////////////////////////////////////////////////////////////////
+	PatternDatabase(std::vector<int> const& pattern, std::string const& file, unsigned threads) : tiles(pattern)
+	{
+		entries = 1;
+		for (size_t i = 0; i < tiles.size(); ++i) {
+			entries *= 16 - i;
+		}
+		if (!Map(file)) {
+			Build(file, threads);
+			if (!Map(file)) {
+				throw "cannot map the pattern database";
+			}
+		}
+	}
+	////////////////////////////////////////////////////////////////////////////
+	~PatternDatabase() {
+		if (mapping) {
+			munmap(mapping, mapping_size);
+		}
+	}
+	PatternDatabase(PatternDatabase const&) = delete;
+	PatternDatabase& operator=(PatternDatabase const&) = delete;
+
+	std::vector<int> const& Tiles() const { return tiles; }
+	size_t Entries() const { return entries; }
+
+	////////////////////////////////////////////////////////////////////////////
+	// position[tile] is the cell of the tile
+	int Lookup(int const * position) const
+	{
+		return values[Rank([this, position](size_t i) { return position[tiles[i]]; })];
+	}
+private:
+	////////////////////////////////////////////////////////////////////////////
+	// placement -> 0 .. entries-1: digit i is the cell of tiles[i] among the cells
+	// the tiles before it left free
+	template<typename Cells>
+	size_t Rank(Cells cell) const
+	{
+		size_t rank = 0;
+		unsigned used = 0;
+		for (size_t i = 0; i < tiles.size(); ++i) {
+			int c = cell(i);
+			size_t below = std::bitset<16>(used & ((1u << c) - 1)).count();
+			rank = rank * (16 - i) + static_cast<size_t>(c) - below;
+			used |= 1u << c;
+		}
+		return rank;
+	}
+	////////////////////////////////////////////////////////////////////////////
+	void Unrank(size_t rank, int * cells) const
+	{
+		size_t digits[16];
+		for (size_t i = tiles.size(); i-- > 0; ) {
+			digits[i] = rank % (16 - i);
+			rank /= 16 - i;
+		}
+		unsigned used = 0;
+		for (size_t i = 0; i < tiles.size(); ++i) {
+			int c = 0;
+			for (size_t free_cells = 0; ; ++c) {
+				if (!(used & (1u << c)) && free_cells++ == digits[i]) {
+					break;
+				}
+			}
+			cells[i] = c;
+			used |= 1u << c;
+		}
+	}
+	////////////////////////////////////////////////////////////////////////////
+	// cells the blank reaches from cell without moving a pattern tile
+	static unsigned Region(int cell, unsigned occupied)
+	{
+		unsigned free_cells = ~occupied & 0xFFFF;
+		unsigned region = 0;
+		unsigned grown = 1u << cell;
+		while (grown != region) {
+			region = grown;
+			grown = region | ((region << 4 | region >> 4 | (region << 1 & 0xEEEE) | (region >> 1 & 0x7777)) & free_cells);
+		}
+		return region;
+	}
+	static int LowestCell(unsigned mask)
+	{
+		int c = 0;
+		while (!(mask & (1u << c))) {
+			++c;
+		}
+		return c;
+	}
+	////////////////////////////////////////////////////////////////////////////
+	// splits [0, n) between the threads
+	template<typename Work>
+	static void ParallelFor(size_t n, unsigned threads, Work work)
+	{
+		std::vector<std::thread> workers;
+		size_t chunk = (n + threads - 1) / threads;
+		for (size_t begin = 0; begin < n; begin += chunk) {
+			workers.push_back(std::thread(work, begin, std::min(n, begin + chunk)));
+		}
+		for (std::thread & worker : workers) {
+			worker.join();
+		}
+	}
+	////////////////////////////////////////////////////////////////////////////
+	// Breadth-first search over (placement, region of the blank), one bit per
+	// state: state = rank * 16 + lowest cell of the region. Moving the blank inside
+	// its region costs nothing, so one layer is one move of a pattern tile.
+	void Build(std::string const& file, unsigned threads) const
+	{
+		std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+		size_t words = entries * 16 / 64;
+		std::vector< std::atomic<std::uint64_t> > visited(words);
+		std::vector< std::atomic<std::uint64_t> > next(words);
+		std::vector< std::uint64_t > frontier(words, 0);
+		std::vector< unsigned char > table(entries, 0xFF);
+
+		int goal_cells[16] = {};
+		unsigned occupied = 0;
+		for (size_t i = 0; i < tiles.size(); ++i) {
+			goal_cells[i] = tiles[i] - 1;
+			occupied |= 1u << goal_cells[i];
+		}
+		size_t goal_rank = Rank([&goal_cells](size_t i) { return goal_cells[i]; });
+		size_t goal_state = goal_rank * 16 + static_cast<size_t>(LowestCell(Region(15, occupied)));
+		visited[goal_state / 64].store(std::uint64_t(1) << (goal_state % 64));
+		frontier[goal_state / 64] = std::uint64_t(1) << (goal_state % 64);
+		table[goal_rank] = 0;
+
+		for (unsigned depth = 0; ; ++depth) {
+			ParallelFor(words, threads, [&](size_t begin, size_t end) {
+				int cells[16];
+				for (size_t w = begin; w < end; ++w) {
+					for (std::uint64_t bits = frontier[w]; bits; bits &= bits - 1) {
+						size_t state = w * 64 + static_cast<size_t>(LowestCell64(bits));
+						Unrank(state / 16, cells);
+						unsigned used = 0;
+						for (size_t i = 0; i < tiles.size(); ++i) {
+							used |= 1u << cells[i];
+						}
+						unsigned region = Region(static_cast<int>(state % 16), used);
+						for (size_t i = 0; i < tiles.size(); ++i) {
+							int from = cells[i];
+							int targets[4] = { from - 4, from + 4, from % 4 > 0 ? from - 1 : -1, from % 4 < 3 ? from + 1 : -1 };
+							for (int to : targets) {
+								if (to < 0 || to > 15 || !(region & (1u << to))) {
+									continue;
+								}
+								cells[i] = to;
+								unsigned moved = used ^ (1u << from) ^ (1u << to);
+								size_t child = Rank([&cells](size_t j) { return cells[j]; }) * 16
+									+ static_cast<size_t>(LowestCell(Region(from, moved)));
+								std::uint64_t bit = std::uint64_t(1) << (child % 64);
+								if (!(visited[child / 64].fetch_or(bit, std::memory_order_relaxed) & bit)) {
+									next[child / 64].fetch_or(bit, std::memory_order_relaxed);
+								}
+							}
+							cells[i] = from;
+						}
+					}
+				}
+			});
+
+			// a placement gets the depth its first state was reached at, then next becomes the frontier
+			std::atomic<size_t> reached(0);
+			std::atomic<size_t> live(0);
+			ParallelFor(words, threads, [&](size_t begin, size_t end) {
+				size_t placements = 0;
+				size_t states = 0;
+				for (size_t w = begin; w < end; ++w) {
+					std::uint64_t bits = next[w].exchange(0, std::memory_order_relaxed);
+					frontier[w] = bits;
+					states += std::bitset<64>(bits).count();
+					for (size_t part = 0; part < 4; ++part) {
+						size_t rank = w * 4 + part;
+						if (((bits >> (16 * part)) & 0xFFFF) && table[rank] == 0xFF) {
+							table[rank] = static_cast<unsigned char>(depth + 1);
+							++placements;
+						}
+					}
+				}
+				reached += placements;
+				live += states;
+			});
+			if (live == 0) {
+				break;
+			}
+			std::cout << "depth " << depth + 1 << " states " << live << " new placements " << reached << std::endl;
+		}
+
+		std::ofstream out(file, std::ios::binary);
+		out.write("PDB1", 4);
+		out.put(static_cast<char>(tiles.size()));
+		for (int tile : tiles) {
+			out.put(static_cast<char>(tile));
+		}
+		out.write(reinterpret_cast<char const*>(table.data()), static_cast<std::streamsize>(entries));
+		std::chrono::duration<double> elapsed_seconds = std::chrono::system_clock::now() - start;
+		std::cout << "built " << file << " in " << elapsed_seconds.count() << " s" << std::endl;
+	}
+	static int LowestCell64(std::uint64_t bits)
+	{
+		int c = 0;
+		while (!(bits & (std::uint64_t(1) << c))) {
+			++c;
+		}
+		return c;
+	}
+	////////////////////////////////////////////////////////////////////////////
+	// maps the file if it holds this pattern
+	bool Map(std::string const& file)
+	{
+		int fd = open(file.c_str(), O_RDONLY);
+		if (fd < 0) {
+			return false;
+		}
+		struct stat info;
+		size_t header = 5 + tiles.size();
+		if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) != header + entries) {
+			close(fd);
+			return false;
+		}
+		void * base = mmap(nullptr, header + entries, PROT_READ, MAP_SHARED, fd, 0);
+		close(fd);
+		if (base == MAP_FAILED) {
+			return false;
+		}
+		unsigned char const * bytes = static_cast<unsigned char const*>(base);
+		bool same = std::string(reinterpret_cast<char const*>(bytes), 4) == "PDB1" && bytes[4] == tiles.size();
+		for (size_t i = 0; same && i < tiles.size(); ++i) {
+			same = bytes[5 + i] == tiles[i];
+		}
+		if (!same) {
+			munmap(base, header + entries);
+			return false;
+		}
+		mapping = base;
+		mapping_size = header + entries;
+		values = bytes + header;
+		return true;
+	}
+};
+
 class FifteenSolver {
+	friend class FifteenDomain;
 	int ** board = nullptr;
 	int * data = nullptr;
 	int height = 0;
 	int width = 0;
-	int num_moves = 0;        // move counter (does not count undo's
+	long long num_moves = 0;  // move counter (does not count undo's
+	bool verbose = true;      // print the iterations and the timing
+
+	// IDA* state (SolveIDA) - fixed size, nothing is allocated while searching
+	std::uint64_t packed = 0;          // 4 bits per cell, row major, 0 is the blank
+	std::uint64_t goal = 0;            // packed solved board
+	int blank = 0;                     // cell of the blank
+	int manhattan = 0;                 // sum of the tile distances
+	int conflicts = 0;                 // sum of the row and column conflicts
+	int row_conflicts[16] = {};
+	int column_conflicts[16] = {};
+	int distance[16][16] = {};         // [tile][cell] moves from cell to the goal cell of tile
+	std::vector< PatternDatabase const* > patterns; // disjoint, empty for Manhattan only
+	int position[16] = {};             // cell of every tile
+	int pattern_of[16] = {};           // database of every tile, -1 for none
+	int pattern_values[16] = {};       // current value of every database
+	int pattern_sum = 0;
 public:
 	////////////////////////////////////////////////////////////////////////////
 	////////////////////////////////////////////////////////////////////////////
@@ -47,7 +340,52 @@ public:
 		std::chrono::duration<double> elapsed_seconds = end - start;
 		std::cout << "Time elapsed " << elapsed_seconds.count() << std::endl;
 		std::cout << "Number of moves " << num_moves << std::endl;
-		std::cout << "Moves per second " << num_moves / elapsed_seconds.count() << std::endl;
+		std::cout << "Moves per second " << static_cast<double>(num_moves) / elapsed_seconds.count() << std::endl;
+
+		return solution;
+	}
+	////////////////////////////////////////////////////////////////////////////
+	// additive pattern databases for SolveIDA (4x4 only), the larger of their sum
+	// and Manhattan plus conflicts is used. The databases must outlive the solver.
+	void UsePatterns(std::vector< PatternDatabase const* > const& databases)
+	{
+		if (!databases.empty() && (height != 4 || width != 4)) {
+			throw "pattern databases are for the 4x4 board";
+		}
+		patterns = databases;
+	}
+	void Verbose(bool v) { verbose = v; }
+	long long Moves() const { return num_moves; }
+	////////////////////////////////////////////////////////////////////////////
+	// optimal: IDA* with Manhattan distance plus linear conflicts on a copy of
+	// the board packed into 64 bits (so at most 16 cells). Same solution order as Solve.
+	std::vector< Direction > SolveIDA(int max_depth)
+	{
+		if (height*width > 16) {
+			throw "SolveIDA packs the board into 64 bits, 16 cells max";
+		}
+		std::vector< Direction > solution;
+		InitPacked();
+
+		std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+		int bound = Heuristic();
+		bool found = false;
+		while (!found && bound <= max_depth) {
+			int next_bound = std::numeric_limits<int>::max();
+			found = IDA(solution, 0, bound, next_bound, -1);
+			if (verbose) {
+				std::cout << "Bound " << bound << " moves so far " << num_moves << std::endl;
+			}
+			bound = next_bound;
+		}
+		std::chrono::time_point<std::chrono::system_clock> end = std::chrono::system_clock::now();
+
+		if (verbose) {
+			std::chrono::duration<double> elapsed_seconds = end - start;
+			std::cout << "Time elapsed " << elapsed_seconds.count() << std::endl;
+			std::cout << "Number of moves " << num_moves << std::endl;
+			std::cout << "Moves per second " << static_cast<double>(num_moves) / elapsed_seconds.count() << std::endl;
+		}
 
 		return solution;
 	}
@@ -145,6 +483,250 @@ private:
 		return false;
 	}
 
+	////////////////////////////////////////////////////////////////////////////
+	// depth first search below bound, next_bound gets the smallest f that was cut off
+	bool IDA(
+		std::vector< Direction > & solution,        // will be populated if solution is found
+		int g,                                      // moves made so far
+		int bound,                                  // f limit of this iteration
+		int & next_bound,                           // f limit of the next iteration
+		int back)                                   // direction that undoes the last move, -1 at the root
+	{
+		int f = g + Heuristic();
+		if (f > bound) {
+			next_bound = std::min(next_bound, f);
+			return false;
+		}
+		if (packed == goal) {
+			return true;
+		}
+
+		for (Direction dir : move_order) {
+			if (dir == back || !CanMove(dir)) {
+				continue;
+			}
+			Step step;
+			DoStep(dir, step);
+
+			if (IDA(solution, g + 1, bound, next_bound, (dir + 2) % 4)) {
+				solution.push_back(dir);
+				return true;
+			}
+			UndoStep(step);
+		}
+		return false;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// what a move changed in the IDA* state, enough to take it back
+	struct Step {
+		Direction dir;
+		int old_manhattan;
+		int old_conflicts;
+		int old_pattern_sum;
+		int lines[2];
+		int old_lines[2];
+		int * line_conflicts;
+		int pattern;                             // database of the tile that slid, -1 for none
+		int old_pattern;
+	};
+
+	////////////////////////////////////////////////////////////////////////////
+	void DoStep(Direction dir, Step & step)
+	{
+		++num_moves;
+		step.dir = dir;
+		step.old_manhattan = manhattan;
+		step.old_conflicts = conflicts;
+		step.old_pattern_sum = pattern_sum;
+		int from = blank;
+		int to = MovePacked(dir);
+		step.line_conflicts = UpdateConflicts(dir, from, to, step.lines, step.old_lines);
+		// only the database of the tile that slid changes
+		step.pattern = pattern_of[Cell(from)];
+		step.old_pattern = step.pattern < 0 ? 0 : pattern_values[step.pattern];
+		if (step.pattern >= 0) {
+			pattern_values[step.pattern] = patterns[static_cast<size_t>(step.pattern)]->Lookup(position);
+			pattern_sum += pattern_values[step.pattern] - step.old_pattern;
+		}
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	void UndoStep(Step const & step)
+	{
+		MovePacked(static_cast<Direction>((step.dir + 2) % 4));
+		manhattan = step.old_manhattan;
+		conflicts = step.old_conflicts;
+		step.line_conflicts[step.lines[0]] = step.old_lines[0];
+		step.line_conflicts[step.lines[1]] = step.old_lines[1];
+		if (step.pattern >= 0) {
+			pattern_values[step.pattern] = step.old_pattern;
+		}
+		pattern_sum = step.old_pattern_sum;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	int Heuristic() const
+	{
+		return std::max(manhattan + conflicts, pattern_sum);
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	int Cell(int cell) const
+	{
+		return static_cast<int>((packed >> (4 * cell)) & 0xF);
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	bool CanMove(Direction dir) const
+	{
+		switch (dir) {
+		case up:    return blank >= width;
+		case down:  return blank < (height - 1)*width;
+		case left:  return blank % width > 0;
+		case right: return blank % width < width - 1;
+		}
+		return false;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// moves the blank, slides the tile and updates the Manhattan distance
+	// returns the old cell of the tile
+	int MovePacked(Direction dir)
+	{
+		int cell = blank;
+		switch (dir) {
+		case up:    cell -= width; break;
+		case down:  cell += width; break;
+		case left:  --cell; break;
+		case right: ++cell; break;
+		}
+		int tile = Cell(cell);
+		manhattan += distance[tile][blank] - distance[tile][cell];
+		packed &= ~(std::uint64_t(0xF) << (4 * cell));
+		packed |= std::uint64_t(tile) << (4 * blank);
+		position[tile] = blank;
+		position[0] = cell;
+		blank = cell;
+		return cell;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// a vertical move changes the rows of both cells, a horizontal move their columns
+	// returns the conflict array that was changed, lines and old values are filled in
+	int * UpdateConflicts(Direction dir, int from, int to, int lines[2], int old_lines[2])
+	{
+		bool vertical = dir == up || dir == down;
+		int * line_conflicts = vertical ? row_conflicts : column_conflicts;
+		lines[0] = vertical ? from / width : from % width;
+		lines[1] = vertical ? to / width : to % width;
+		for (int i = 0; i < 2; ++i) {
+			old_lines[i] = line_conflicts[lines[i]];
+			int updated = vertical ? RowConflicts(lines[i]) : ColumnConflicts(lines[i]);
+			conflicts += updated - old_lines[i];
+			line_conflicts[lines[i]] = updated;
+		}
+		return line_conflicts;
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// 2 moves for every tile that has to leave its goal line so that the rest
+	// are in order: 2 * (tiles in their goal line - longest increasing run)
+	static int LineConflicts(int const * goals, int count)
+	{
+		int longest = 0;
+		int run[16];
+		for (int i = 0; i < count; ++i) {
+			run[i] = 1;
+			for (int j = 0; j < i; ++j) {
+				if (goals[j] < goals[i] && run[j] + 1 > run[i]) {
+					run[i] = run[j] + 1;
+				}
+			}
+			longest = std::max(longest, run[i]);
+		}
+		return 2 * (count - longest);
+	}
+
+	int RowConflicts(int row) const
+	{
+		int goals[16];
+		int count = 0;
+		for (int j = 0; j < width; ++j) {
+			int tile = Cell(row*width + j);
+			if (tile != 0 && (tile - 1) / width == row) {
+				goals[count++] = (tile - 1) % width;
+			}
+		}
+		return LineConflicts(goals, count);
+	}
+
+	int ColumnConflicts(int column) const
+	{
+		int goals[16];
+		int count = 0;
+		for (int i = 0; i < height; ++i) {
+			int tile = Cell(i*width + column);
+			if (tile != 0 && (tile - 1) % width == column) {
+				goals[count++] = (tile - 1) / width;
+			}
+		}
+		return LineConflicts(goals, count);
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// packs the board and computes the heuristic from scratch
+	void InitPacked()
+	{
+		packed = goal = 0;
+		for (int k = 0; k < height*width; ++k) {
+			packed |= std::uint64_t(data[k]) << (4 * k);
+			if (k < height*width - 1) {
+				goal |= std::uint64_t(k + 1) << (4 * k);
+			}
+		}
+		for (int tile = 0; tile < height*width; ++tile) {
+			for (int k = 0; k < height*width; ++k) {
+				// the blank does not count
+				distance[tile][k] = tile == 0 ? 0
+					: std::abs((tile - 1) / width - k / width) + std::abs((tile - 1) % width - k % width);
+			}
+		}
+		LoadPacked(packed);
+	}
+
+	////////////////////////////////////////////////////////////////////////////
+	// replaces the packed board and computes the rest of the IDA* state from it
+	void LoadPacked(std::uint64_t state)
+	{
+		packed = state;
+		for (int k = 0; k < height*width; ++k) {
+			position[Cell(k)] = k;
+		}
+		blank = position[0];
+		manhattan = conflicts = 0;
+		for (int k = 0; k < height*width; ++k) {
+			manhattan += distance[Cell(k)][k];
+		}
+		for (int i = 0; i < height; ++i) {
+			row_conflicts[i] = RowConflicts(i);
+			conflicts += row_conflicts[i];
+		}
+		for (int j = 0; j < width; ++j) {
+			column_conflicts[j] = ColumnConflicts(j);
+			conflicts += column_conflicts[j];
+		}
+		pattern_sum = 0;
+		std::fill(pattern_of, pattern_of + 16, -1);
+		for (size_t p = 0; p < patterns.size(); ++p) {
+			for (int tile : patterns[p]->Tiles()) {
+				pattern_of[tile] = static_cast<int>(p);
+			}
+			pattern_values[p] = patterns[p]->Lookup(position);
+			pattern_sum += pattern_values[p];
+		}
+	}
+
 	////////////////////////////////////////////////////////////////////////////
 	// true if current state is the goal
 	bool AreWeDone() const
@@ -209,6 +791,62 @@ public:
 	}
 };
 
+////////////////////////////////////////////////////////////////////////////////
+// FifteenSolver's packed IDA* state seen through the domain interface of search.h.
+// Moves are the directions the blank moves in, the reverse of the last move is left out.
+class FifteenDomain {
+public:
+	typedef Direction Move;
+	typedef std::uint64_t State;
+
+private:
+	FifteenSolver & solver;
+	std::vector< FifteenSolver::Step > steps;  // applied moves with what they changed
+
+public:
+	explicit FifteenDomain(FifteenSolver & solver) : solver(solver)
+	{
+		if (solver.height*solver.width > 16) {
+			throw "the packed board holds at most 16 cells";
+		}
+		solver.InitPacked();
+	}
+
+	void Moves(std::vector< Direction > & moves) const
+	{
+		for (Direction dir : move_order) {
+			if (solver.CanMove(dir) && (steps.empty() || dir != (steps.back().dir + 2) % 4)) {
+				moves.push_back(dir);
+			}
+		}
+	}
+
+	void Apply(Direction dir)
+	{
+		steps.push_back(FifteenSolver::Step());
+		solver.DoStep(dir, steps.back());
+	}
+
+	void Undo(Direction)
+	{
+		solver.UndoStep(steps.back());
+		steps.pop_back();
+	}
+
+	std::uint64_t Hash() const { return solver.packed * 0x9E3779B97F4A7C15ull; }
+	std::uint64_t Save() const { return solver.packed; }
+	bool Equals(std::uint64_t state) const { return solver.packed == state; }
+
+	void Load(std::uint64_t state)
+	{
+		solver.LoadPacked(state);
+		steps.clear();
+	}
+
+	bool IsGoal() const { return solver.packed == solver.goal; }
+	unsigned Heuristic() const { return static_cast<unsigned>(solver.Heuristic()); }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -316,10 +954,151 @@ bool IsEvenPermutation(int * data, int size)
 }
 
 
-#include <random>
-int mainfake()
+////////////////////////////////////////////////////////////////////////////////
+// with an even width moving the blank up or down changes the parity of the
+// inversions, so the row of the blank counts too (goal has it on the bottom row)
+bool IsSolvable(int * data, int height, int width)
 {
-	int height = 3, width = 3;
+	if (width % 2) {
+		return IsEvenPermutation(data, height*width);
+	}
+	int blank = 0;
+	while (data[blank] != 0) {
+		++blank;
+	}
+	int row_from_bottom = height - blank / width;
+	return IsEvenPermutation(data, height*width) == (row_from_bottom % 2 == 1);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// disjoint patterns of the 4x4 board, files are built in the current directory
+// the first time: "663" (6-6-3) or "78" (7-8, building the 8 tile part needs about
+// 3.6 GB of memory, the file is 519 MB)
+std::vector< std::unique_ptr<PatternDatabase> > LoadPatterns(std::string const& name)
+{
+	std::vector< std::vector<int> > sets;
+	if (name == "663") {
+		sets = { { 1, 5, 6, 9, 10, 13 }, { 7, 8, 11, 12, 14, 15 }, { 2, 3, 4 } };
+	}
+	else if (name == "78") {
+		sets = { { 1, 4, 5, 8, 9, 12, 13 }, { 2, 3, 6, 7, 10, 11, 14, 15 } };
+	}
+	else {
+		throw "unknown pattern set, expected 663 or 78";
+	}
+	unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+	std::vector< std::unique_ptr<PatternDatabase> > databases;
+	for (std::vector<int> const& tiles : sets) {
+		std::string file = "15puzzle";
+		for (int tile : tiles) {
+			file += "-" + std::to_string(tile);
+		}
+		databases.push_back(std::unique_ptr<PatternDatabase>(new PatternDatabase(tiles, file + ".pdb", threads)));
+	}
+	return databases;
+}
+
+std::vector< PatternDatabase const* > Pointers(std::vector< std::unique_ptr<PatternDatabase> > const& databases)
+{
+	std::vector< PatternDatabase const* > pointers;
+	for (std::unique_ptr<PatternDatabase> const& database : databases) {
+		pointers.push_back(database.get());
+	}
+	return pointers;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Fixed set of random solvable 4x4 boards (same seed every run). Every board is
+// solved by IDA* with Manhattan plus conflicts, again with the pattern databases and
+// once more by the IDA* of search.h with the pattern databases.
+int Benchmark(int count, std::string const& pattern_set)
+{
+	std::vector< std::unique_ptr<PatternDatabase> > databases = LoadPatterns(pattern_set);
+	std::mt19937 gen(15);
+	int data[16];
+	int * board[4] = { data, data + 4, data + 8, data + 12 };
+	double total_seconds[3] = {};
+	long long total_moves[3] = {};
+
+	std::cout << "board length manhattan_s manhattan_moves pdb_s pdb_moves speedup generic_s generic_moves" << std::endl;
+	for (int n = 0; n < count; ++n) {
+		for (int k = 0; k < 16; ++k) {
+			data[k] = (k + 1) % 16;
+		}
+		do {
+			for (int k = 15; k > 0; --k) {
+				std::swap(data[k], data[gen() % static_cast<unsigned>(k + 1)]);
+			}
+		} while (!IsSolvable(data, 4, 4));
+
+		size_t length[3];
+		double seconds[3];
+		long long moves[3];
+		for (int mode = 0; mode < 3; ++mode) {
+			FifteenSolver fs(board, 4, 4);
+			fs.Verbose(false);
+			if (mode > 0) {
+				fs.UsePatterns(Pointers(databases));
+			}
+			std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+			if (mode < 2) {
+				length[mode] = fs.SolveIDA(100).size();
+			}
+			else {
+				FifteenDomain domain(fs);
+				GenericSearch< FifteenDomain > search(domain);
+				search.Transpositions(false);
+				std::vector< Direction > path;
+				search.IDAStar(path, 100);
+				length[mode] = path.size();
+			}
+			std::chrono::duration<double> elapsed_seconds = std::chrono::system_clock::now() - start;
+			seconds[mode] = elapsed_seconds.count();
+			moves[mode] = fs.Moves();
+			total_seconds[mode] += seconds[mode];
+			total_moves[mode] += moves[mode];
+		}
+		if (length[0] != length[1] || length[0] != length[2]) {
+			std::cout << "board " << n << " solution lengths differ " << length[0] << " " << length[1] << " " << length[2] << std::endl;
+			return 1;
+		}
+		std::cout << n << " " << length[0] << " " << seconds[0] << " " << moves[0] << " " << seconds[1] << " " << moves[1]
+			<< " " << seconds[0] / seconds[1] << " " << seconds[2] << " " << moves[2] << std::endl;
+	}
+	std::cout << "total manhattan " << total_seconds[0] << " s " << total_moves[0] << " moves, pdb "
+		<< total_seconds[1] << " s " << total_moves[1] << " moves, speedup " << total_seconds[0] / total_seconds[1]
+		<< ", generic pdb " << total_seconds[2] << " s " << total_moves[2] << " moves" << std::endl;
+	return 0;
+}
+
+
+// what the solvers threw, with the arguments they take
+int UsageError(char const* msg)
+{
+	std::cerr << "error: " << msg << std::endl
+		<< "usage: <optional height> <optional width> <optional dfs|ida|pdb|generic> <optional 663|78>" << std::endl
+		<< "       bench <optional count> <optional 663|78>" << std::endl
+		<< "ida, pdb and generic take boards of at most 16 cells, the pattern databases the 4x4 one" << std::endl;
+	return 1;
+}
+
+// usage: <optional height> <optional width> <optional dfs|ida|pdb|generic> <optional 663|78>, 3 3 dfs by default
+//        (generic is the IDA* of search.h, with the pattern databases if a set is given)
+//        bench <optional count, 100> <optional 663|78>
+int mainfake(int argc, char ** argv)
+{
+	if (argc > 1 && std::string(argv[1]) == "bench") {
+		try {
+			return Benchmark(argc > 2 ? std::atoi(argv[2]) : 100, argc > 3 ? argv[3] : "663");
+		}
+		catch (char const* msg) {
+			return UsageError(msg);
+		}
+	}
+	int height = argc > 2 ? std::atoi(argv[1]) : 3;
+	int width = argc > 2 ? std::atoi(argv[2]) : 3;
+	std::string mode = argc > 3 ? argv[3] : "dfs";
 
 	int * data = new int[height*width];
 	int ** board = new int*[height];
@@ -341,7 +1120,7 @@ int mainfake()
 		for (int k = 0; k< height*width * log(height*width); ++k) { // NlogN swap to simulate good shuffle
 			std::swap(data[dis(gen)], data[dis(gen)]);
 		}
-	} while (!IsEvenPermutation(data, height*width));
+	} while (!IsSolvable(data, height, width));
 
 	// if you want to test on a specific board - define it here:
 
@@ -371,23 +1150,49 @@ int mainfake()
 	FifteenSolver fs(board, height, width);
 	fs.Print();
 
-	// maximum necessary steps to solve mxn puzzle (if solvable)
-	//    .n\m...1...2...3...4...5...6...7...8...9
-	//    .----------------------------------------
-	//    .1.|...0...1...2...3...4...5...6...7...8
-	//    .2.|...1...6..21..36..55..80.108.140
-	//    .3.|...2..21..31..53..84
-	//    .4.|...3..36..53..80
-	//    .5.|...4..55..84
-	//    .6.|...5..80
-	//    .7.|...6.108
-	//    .8.|...7.140
-	//    .9.|...8
 	std::vector< Direction> sol;
+	try {
+		std::vector< std::unique_ptr<PatternDatabase> > databases;
+		if (mode == "pdb" || (mode == "generic" && argc > 4)) {
+			databases = LoadPatterns(argc > 4 ? argv[4] : "663");
+			fs.UsePatterns(Pointers(databases));
+		}
 
-	//sol = fs.Solve( std::numeric_limits<int>::max() ); // will almost definitely blow the stack
-	sol = fs.Solve(100); // max depth level
-						 // play with the maximum depth parameter to get good understanding of how to solve optimally
+		// maximum necessary steps to solve mxn puzzle (if solvable)
+		//    .n\m...1...2...3...4...5...6...7...8...9
+		//    .----------------------------------------
+		//    .1.|...0...1...2...3...4...5...6...7...8
+		//    .2.|...1...6..21..36..55..80.108.140
+		//    .3.|...2..21..31..53..84
+		//    .4.|...3..36..53..80
+		//    .5.|...4..55..84
+		//    .6.|...5..80
+		//    .7.|...6.108
+		//    .8.|...7.140
+		//    .9.|...8
+
+		//sol = fs.Solve( std::numeric_limits<int>::max() ); // will almost definitely blow the stack
+		if (mode == "ida" || mode == "pdb") {
+			sol = fs.SolveIDA(100); // optimal, the 4x4 needs at most 80
+		}
+		else if (mode == "generic") {
+			FifteenDomain domain(fs);
+			GenericSearch< FifteenDomain > search(domain);
+			search.Transpositions(false); // the pattern databases make IDA* cheaper than a closed list
+			std::vector< Direction > path;
+			search.IDAStar(path, 100);
+			sol.assign(path.rbegin(), path.rend()); // the checker takes the moves last first
+		}
+		else {
+			sol = fs.Solve(100); // max depth level
+								 // play with the maximum depth parameter to get good understanding of how to solve optimally
+		}
+	}
+	catch (char const* msg) {
+		delete[] data;
+		delete[] board;
+		return UsageError(msg);
+	}
 
 	FifteenChecker fc(board, height, width, false);
 	fc.Check(sol);
@@ -0,0 +1,419 @@
+/*!
+* \file benchmark.cpp
+* \author Egemen Koku
+* \date 19 Oct 2026
+* \brief Impl of @b benchmark.cpp
+*
+* \copyright Digipen Institute of Technology
+*
+*/
+
+#include "benchmark.h"
+#include "validator.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+	// keeps the compiler from dropping work whose result nobody reads
+#if defined(__GNUC__)
+	template<typename T>
+	void Escape(T const & value)
+	{
+		__asm__ __volatile__("" : : "r"(&value) : "memory");
+	}
+#else
+	void const * volatile escaped = nullptr;
+
+	template<typename T>
+	void Escape(T const & value)
+	{
+		escaped = &value;
+	}
+#endif
+}
+
+HardwareCounters::HardwareCounters(bool enabled)
+{
+	for (int & event : events) {
+		event = -1;
+	}
+#ifdef __linux__
+	if (!enabled)
+		return;
+	static std::uint64_t const configs[hardwareEvents] = {
+		PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_CACHE_MISSES
+	};
+	// one group, so the events count over the same stretches
+	int leader = -1;
+	for (unsigned event = 0; event < hardwareEvents; ++event) {
+		perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.size = sizeof(attr);
+		attr.config = configs[event];
+		if (leader < 0)
+			attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		events[event] = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0));
+		if (leader < 0)
+			leader = events[event];
+	}
+#else
+	static_cast<void>(enabled);
+#endif
+}
+
+HardwareCounters::~HardwareCounters()
+{
+#ifdef __linux__
+	for (int event : events) {
+		if (event >= 0)
+			close(event);
+	}
+#endif
+}
+
+#ifdef __linux__
+namespace {
+	// the group is started, stopped and reset through its leader, the first event open
+	void GroupControl(int const (&events)[hardwareEvents], unsigned long request)
+	{
+		for (int event : events) {
+			if (event >= 0) {
+				ioctl(event, request, PERF_IOC_FLAG_GROUP);
+				return;
+			}
+		}
+	}
+}
+#endif
+
+void HardwareCounters::Reset()
+{
+#ifdef __linux__
+	GroupControl(events, PERF_EVENT_IOC_RESET);
+#endif
+}
+
+void HardwareCounters::Start()
+{
+#ifdef __linux__
+	GroupControl(events, PERF_EVENT_IOC_ENABLE);
+#endif
+}
+
+void HardwareCounters::Stop()
+{
+#ifdef __linux__
+	GroupControl(events, PERF_EVENT_IOC_DISABLE);
+#endif
+}
+
+std::uint64_t HardwareCounters::Read(HardwareEvent event) const
+{
+	std::uint64_t value = 0;
+#ifdef __linux__
+	if (events[event] >= 0 && read(events[event], &value, sizeof(value)) != sizeof(value))
+		value = 0;
+#else
+	static_cast<void>(event);
+#endif
+	return value;
+}
+
+SolverBenchmark::SolverBenchmark(std::string const & filename, BenchOptions const & options)
+: filename(filename), options(options), solver(filename), initial(filename), counters(options.counters)
+{
+	solver.InitCarLocations();
+	solver.ClosedListOpt(options.closedList);
+	solver.PartialOrderOpt(options.partialOrder);
+	solver.Ordering(options.ordering);
+	solver.HashCheck(options.hashCheck);
+	if (options.filterStates > 0)
+		solver.Filter(options.filterStates);
+	initial = solver;
+	Explore();
+}
+
+void SolverBenchmark::Explore()
+{
+	CarLocations start = solver.currentCarLocations;
+	std::vector<CarLocations> states(1, start);
+	explored.Stride(start.size());
+	explored.Insert(solver.stateHash, solver.Key());
+	hashes.push_back(solver.stateHash);
+	keys.append(solver.Key(), start.size());
+
+	MoveCursor cursor;
+	std::tuple<unsigned, Direction, unsigned> move;
+	for (size_t next = 0; next < states.size() && states.size() < options.exploredStates; ++next) {
+		solver.LoadState(states[next]);
+		solver.StartMoves(cursor, nullptr);
+		while (states.size() < options.exploredStates && solver.NextMove(cursor, move)) {
+			solver.MoveCar(move);
+			char const * key = solver.Key();
+			if (explored.Find(solver.stateHash, key) == StateTable::noState) {
+				explored.Insert(solver.stateHash, key);
+				hashes.push_back(solver.stateHash);
+				keys.append(key, start.size());
+				states.push_back(solver.currentCarLocations);
+			}
+			solver.MoveCar(ReverseMove(move));
+		}
+	}
+
+	// evenly spread over the breadth-first order, a board with no moves is passed over
+	size_t wanted = std::min(options.boards, states.size());
+	for (size_t i = 0; i < wanted; ++i) {
+		CarLocations const & board = states[i * states.size() / wanted];
+		solver.LoadState(board);
+		MoveList moves;
+		solver.ListMoves(moves);
+		if (moves.empty())
+			continue;
+		boards.push_back(board);
+		boardMoves.push_back(moves);
+	}
+	solver.LoadState(start);
+}
+
+template<typename Primitive>
+BenchStats SolverBenchmark::Measure(std::string const & name, bool perBoard, Primitive run)
+{
+	size_t passes = perBoard ? boards.size() : 1;
+	// seconds of running every board once, operations times each
+	auto pass = [&](unsigned long long operations) -> double {
+		double seconds = 0;
+		for (size_t board = 0; board < passes; ++board) {
+			if (perBoard)
+				solver.LoadState(boards[board]);
+			counters.Start();
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			run(board, operations);
+			std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+			counters.Stop();
+			seconds += elapsed.count();
+		}
+		return seconds;
+	};
+
+	// doubled until a pass takes a sample's time
+	unsigned long long operations = 1;
+	while (pass(operations) < options.sampleTime && operations < (1ull << 40)) {
+		operations *= 2;
+	}
+	std::chrono::steady_clock::time_point warmup = std::chrono::steady_clock::now();
+	do {
+		pass(operations);
+	} while (std::chrono::duration<double>(std::chrono::steady_clock::now() - warmup).count() < options.warmupTime);
+
+	BenchStats stats;
+	stats.name = name;
+	stats.samples = std::max(options.samples, 1u);
+	stats.operations = operations * passes;
+	std::vector<double> samples;
+	counters.Reset();
+	for (size_t sample = 0; sample < stats.samples; ++sample) {
+		samples.push_back(pass(operations) * 1e9 / static_cast<double>(stats.operations));
+	}
+	if (perBoard && !boards.empty())
+		solver.LoadState(boards.front());
+
+	std::sort(samples.begin(), samples.end());
+	size_t middle = samples.size() / 2;
+	stats.median = samples.size() % 2 ? samples[middle] : (samples[middle - 1] + samples[middle]) / 2;
+	stats.min = samples.front();
+	stats.max = samples.back();
+	for (double sample : samples) {
+		stats.mean += sample;
+	}
+	stats.mean /= static_cast<double>(samples.size());
+	for (double sample : samples) {
+		stats.deviation += (sample - stats.mean) * (sample - stats.mean);
+	}
+	stats.deviation = std::sqrt(stats.deviation / static_cast<double>(samples.size()));
+
+	double total = static_cast<double>(stats.operations) * static_cast<double>(stats.samples);
+	for (unsigned event = 0; event < hardwareEvents; ++event) {
+		stats.counted[event] = counters.Available(static_cast<HardwareEvent>(event));
+		stats.perEvent[event] = static_cast<double>(counters.Read(static_cast<HardwareEvent>(event))) / total;
+	}
+	return stats;
+}
+
+BenchStats SolverBenchmark::MeasureSearch(std::string const & name, bool (RushHourSolver::*solve)(MoveList &))
+{
+	RushHourSolver probe(initial);
+	MoveList moves;
+	bool solved = (probe.*solve)(moves);
+	std::string described = name + ", " + std::to_string(probe.Nodes()) + " nodes" + (solved ? "" : ", unsolved");
+	return Measure(described, false, [&](size_t, unsigned long long operations) {
+		for (unsigned long long i = 0; i < operations; ++i) {
+			RushHourSolver searcher(initial);
+			MoveList found;
+			bool result = (searcher.*solve)(found);
+			Escape(result);
+		}
+	});
+}
+
+std::vector<BenchStats> SolverBenchmark::Run()
+{
+	std::vector<BenchStats> results;
+	if (boards.empty())
+		return results;
+
+	results.push_back(Measure("constructor", false, [&](size_t, unsigned long long operations) {
+		for (unsigned long long i = 0; i < operations; ++i) {
+			RushHourSolver parsed(filename);
+			Escape(parsed);
+		}
+	}));
+
+	// the board is back where it was after every pair
+	results.push_back(Measure("MoveCar + reverse", true, [&](size_t board, unsigned long long operations) {
+		MoveList const & moves = boardMoves[board];
+		size_t next = 0;
+		for (unsigned long long i = 0; i < operations; ++i) {
+			solver.MoveCar(moves[next]);
+			solver.MoveCar(ReverseMove(moves[next]));
+			if (++next == moves.size())
+				next = 0;
+		}
+		Escape(solver.stateHash);
+	}));
+
+	results.push_back(Measure("CalculatePossibleMoves", true, [&](size_t, unsigned long long operations) {
+		for (unsigned long long i = 0; i < operations; ++i) {
+			PossibleMoveVector possibleMoves;
+			ReverseMoveVector reverseMoves;
+			solver.CalculatePossibleMoves(possibleMoves, reverseMoves, nullptr);
+			Escape(possibleMoves);
+		}
+	}));
+
+	results.push_back(Measure("StartMoves/NextMove", true, [&](size_t, unsigned long long operations) {
+		MoveCursor cursor;
+		std::tuple<unsigned, Direction, unsigned> move;
+		size_t count = 0;
+		for (unsigned long long i = 0; i < operations; ++i) {
+			solver.StartMoves(cursor, nullptr);
+			while (solver.NextMove(cursor, move)) {
+				++count;
+			}
+		}
+		Escape(count);
+	}));
+
+	results.push_back(Measure("IsSolved", true, [&](size_t, unsigned long long operations) {
+		size_t solved = 0;
+		for (unsigned long long i = 0; i < operations; ++i) {
+			solved += solver.IsSolved();
+			Escape(solved);
+		}
+	}));
+
+	results.push_back(Measure("state copy", true, [&](size_t, unsigned long long operations) {
+		for (unsigned long long i = 0; i < operations; ++i) {
+			CarLocations copy(solver.currentCarLocations);
+			Escape(copy);
+		}
+	}));
+
+	// equal, so every car is compared
+	results.push_back(Measure("state compare", true, [&](size_t board, unsigned long long operations) {
+		size_t equal = 0;
+		for (unsigned long long i = 0; i < operations; ++i) {
+			equal += solver.currentCarLocations == boards[board];
+			Escape(equal);
+		}
+	}));
+
+	results.push_back(Measure("state hash from scratch", true, [&](size_t, unsigned long long operations) {
+		for (unsigned long long i = 0; i < operations; ++i) {
+			StateHash hash = solver.ComputeStateHash();
+			Escape(hash);
+		}
+	}));
+
+	results.push_back(Measure("closed list key", true, [&](size_t, unsigned long long operations) {
+		for (unsigned long long i = 0; i < operations; ++i) {
+			char const * key = solver.Key();
+			Escape(key);
+		}
+	}));
+
+	if (solver.Packable()) {
+		results.push_back(Measure("state pack", true, [&](size_t, unsigned long long operations) {
+			for (unsigned long long i = 0; i < operations; ++i) {
+				std::uint64_t packed = solver.Pack();
+				Escape(packed);
+			}
+		}));
+	}
+
+	// the lookups go through every explored state, the table is as cold as in a search
+	size_t stride = boards.front().size();
+	results.push_back(Measure("closed list hit", false, [&](size_t, unsigned long long operations) {
+		size_t next = 0;
+		for (unsigned long long i = 0; i < operations; ++i) {
+			size_t found = explored.Find(hashes[next], keys.data() + next * stride);
+			Escape(found);
+			if (++next == hashes.size())
+				next = 0;
+		}
+	}));
+
+	// another hash for the same state, it is not there
+	results.push_back(Measure("closed list miss", false, [&](size_t, unsigned long long operations) {
+		size_t next = 0;
+		for (unsigned long long i = 0; i < operations; ++i) {
+			size_t found = explored.Find(hashes[next] ^ 0x9E3779B97F4A7C15ull, keys.data() + next * stride);
+			Escape(found);
+			if (++next == hashes.size())
+				next = 0;
+		}
+	}));
+
+	// the shortest solution of the level, or none when it has none (notSolved then)
+	RushHourSolver shortest(initial);
+	MoveList solution;
+	shortest.SolveBreadthFirst(solution);
+	ParkingLotBoard level = initial.Board();
+	std::string steps = std::to_string(solution.size()) + " moves";
+	SolutionValidator validator;
+	results.push_back(Measure("Validate, " + steps, false, [&](size_t, unsigned long long operations) {
+		for (unsigned long long i = 0; i < operations; ++i) {
+			ValidationReport report = validator.Validate(level, solution);
+			Escape(report);
+		}
+	}));
+
+	// enough pairs for the threads of ValidateBatch to start
+	size_t const pairs = 8192;
+	std::vector<ParkingLotBoard> batchBoards(pairs, level);
+	std::vector<MoveList> batchSolutions(pairs, solution);
+	std::vector<ValidationReport> reports;
+	results.push_back(Measure("ValidateBatch, " + std::to_string(pairs) + " x " + steps, false, [&](size_t, unsigned long long operations) {
+		for (unsigned long long i = 0; i < operations; ++i) {
+			ValidateBatch(batchBoards, batchSolutions, reports);
+			Escape(reports.front());
+		}
+	}));
+
+	if (options.searches) {
+		results.push_back(MeasureSearch("depth first", &RushHourSolver::SolveRushHourRec));
+		results.push_back(MeasureSearch("iterative deepening", &RushHourSolver::SolveIterativeDeepening));
+	}
+	return results;
+}
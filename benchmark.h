@@ -0,0 +1,196 @@
+/*!
+* \file benchmark.h
+* \author Egemen Koku
+* \date 19 Oct 2026
+* \brief Interface of @b benchmark.cpp - micro-benchmarks of the solver primitives
+*
+* \copyright Digipen Institute of Technology
+*
+* Every primitive runs on its own, on boards taken from the breadth-first search of a
+* level, so the time per node of a search can be split into its parts. The timings
+* come after a warm-up, repeated, with their spread. Hardware counters are read through
+* perf_event on Linux when the kernel lets the process open them.
+*/
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "rushhour.h"
+
+// How long and how often every primitive runs
+struct BenchOptions {
+	unsigned samples = 15;                   // timed samples, the spread is over them
+	double sampleTime = 0.01;                // seconds a sample runs at least, decides the operations per sample
+	double warmupTime = 0.05;                // seconds run untimed before the samples
+	size_t boards = 32;                      // boards the primitives run on
+	size_t exploredStates = 65536;           // states of the breadth-first search in the closed list
+	bool counters = true;                    // read the hardware counters if they can be opened
+
+	// Whole searches of the level, with the switches of SearchPolicy for comparing them
+	bool searches = true;                    // time depth first search and iterative deepening too
+	bool closedList = true;
+	bool partialOrder = true;
+	MoveOrdering ordering = naturalOrder;
+	bool hashCheck = false;
+	size_t filterStates = 0;                 // Bloom filter of depth first search for this many states, 0 for none
+};
+
+// Counters of perf_event, in the order HardwareCounters reads them
+enum HardwareEvent { cyclesEvent, instructionsEvent, branchMissesEvent, cacheMissesEvent, hardwareEvents };
+
+// Result of a primitive, nanoseconds per operation
+struct BenchStats {
+	std::string name;
+	size_t samples = 0;
+	unsigned long long operations = 0;       // per sample
+	double median = 0;
+	double mean = 0;
+	double min = 0;
+	double max = 0;
+	double deviation = 0;                    // standard deviation of the samples
+	bool counted[hardwareEvents] = {};       // which of perEvent could be read
+	double perEvent[hardwareEvents] = {};    // per operation, over every sample
+};
+
+/*
+ * User space hardware counters of the process (cycles, instructions, branch misses,
+ * cache misses). An event the kernel or the processor doesn't give is left out, none of
+ * them are there off Linux.
+ */
+class HardwareCounters {
+private:
+	int events[hardwareEvents];              // perf_event file descriptors, -1 if not open
+
+public:
+	/**
+	 * @brief Constructor of the class, opens the events, stopped
+	 * @param enabled Whether to try at all
+	 */
+	explicit HardwareCounters(bool enabled);
+
+	/**
+	 * @brief Destructor of the class, closes the events
+	 */
+	~HardwareCounters();
+
+	HardwareCounters(HardwareCounters const &) = delete;
+	HardwareCounters & operator=(HardwareCounters const &) = delete;
+
+	/**
+	 * @brief Whether an event could be opened
+	 * @param event Event to check
+	 * @return Open or not
+	 */
+	bool Available(HardwareEvent event) const { return events[event] >= 0; }
+
+	/**
+	 * @brief Zeroes the counts
+	 */
+	void Reset();
+
+	/**
+	 * @brief Starts counting
+	 */
+	void Start();
+
+	/**
+	 * @brief Stops counting, the counts are kept
+	 */
+	void Stop();
+
+	/**
+	 * @brief Count of an event since the last Reset
+	 * @param event Event to read
+	 * @return Count, 0 if the event is not open
+	 */
+	std::uint64_t Read(HardwareEvent event) const;
+};
+
+/*
+ * Benchmarks of the primitives of RushHourSolver on a level. The boards are spread over
+ * the breadth-first order of the level, so they go from the start to the states furthest
+ * from it. A primitive with a board runs on each of them in turn, the board is loaded
+ * outside of the timing.
+ */
+class SolverBenchmark {
+private:
+	std::string filename;
+	BenchOptions options;
+	RushHourSolver solver;
+	RushHourSolver initial;                  // as it was after InitCarLocations, the searches start from copies of it
+	std::vector<CarLocations> boards = std::vector<CarLocations>();
+	std::vector<MoveList> boardMoves = std::vector<MoveList>();       // every move of a board, by car index
+	StateTable explored = StateTable();      // states of the breadth-first search, as the closed list keeps them
+	std::vector<StateHash> hashes = std::vector<StateHash>();       // of the explored states, the lookups go through them in order
+	std::string keys = std::string();        // their packed states, back to back
+	HardwareCounters counters;
+
+	/**
+	 * @brief Breadth-first search of the level up to exploredStates, picks the boards
+	 *        from its order and keeps the states in explored
+	 */
+	void Explore();
+
+	/**
+	 * @brief Runs a primitive: calibrates the operations per sample, warms up and takes
+	 *        the samples
+	 * @param name Name of the primitive
+	 * @param perBoard Whether it runs on the boards (loaded before it) or on its own
+	 * @param run Runs the primitive, called with the board and the number of operations
+	 * @return Timings of the primitive
+	 */
+	template<typename Primitive>
+	BenchStats Measure(std::string const & name, bool perBoard, Primitive run);
+
+	/**
+	 * @brief Runs a whole search of the level as a primitive, every operation on a copy of
+	 *        the initial solver (the copy is timed too)
+	 * @param name Name of the search, its nodes are added to it
+	 * @param solve Search to run
+	 * @return Timings of the search
+	 */
+	BenchStats MeasureSearch(std::string const & name, bool (RushHourSolver::*solve)(MoveList &));
+
+public:
+	/**
+	 * @brief Constructor of the class, reads the level and picks the boards
+	 * @param filename The name of the file of the map data
+	 * @param options Samples, their length and the boards
+	 */
+	SolverBenchmark(std::string const & filename, BenchOptions const & options = BenchOptions());
+
+	/**
+	 * @brief Number of boards the primitives run on
+	 * @return Boards, fewer than asked for when the level has fewer states
+	 */
+	size_t Boards() const { return boards.size(); }
+
+	/**
+	 * @brief Number of states in the closed list of the lookups
+	 * @return States
+	 */
+	size_t States() const { return explored.Size(); }
+
+	/**
+	 * @brief Whether an event of the hardware counters is read
+	 * @param event Event to check
+	 * @return Read or not
+	 */
+	bool Counted(HardwareEvent event) const { return counters.Available(event); }
+
+	/**
+	 * @brief Benchmarks every primitive: constructor, MoveCar with its reverse,
+	 *        CalculatePossibleMoves, the move cursor, IsSolved, state copy, compare and
+	 *        hash, the closed list key and lookups, and the validation of the shortest
+	 *        solution of the level, alone and as a ValidateBatch. Then depth first search
+	 *        and iterative deepening with the switches of the options, unless they are
+	 *        turned off.
+	 * @return Timings by primitive
+	 */
+	std::vector<BenchStats> Run();
+};
+
+#endif
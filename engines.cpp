@@ -0,0 +1,264 @@
+/*!
+* \file engines.cpp
+* \author Egemen Koku
+* \date 19 Oct 2026
+* \brief Impl of @b engines.cpp
+*
+* \copyright Digipen Institute of Technology
+*
+*/
+
+#include "engines.h"
+#include "search.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace {
+	// finish - sets the status from what the search returned
+	SolveResult Finish(RushHourSolver const & solver, bool solved, MoveList & moves)
+	{
+		SolveResult result;
+		result.moves.swap(moves);
+		result.nodes = solver.Nodes();
+		result.peakBytes = solver.Memory().total.peak;
+		if (solved) {
+			result.status = statusSolved;
+		}
+		else if (solver.Cancelled()) {
+			result.status = statusCancelled;
+			result.moves.clear();
+		}
+		else if (solver.TimedOut()) {
+			result.status = statusTimedOut;
+			result.moves.clear();
+		}
+		return result;
+	}
+
+	// DFS trying the moves with the best blocker score first
+	SolveResult SolveOrdered(RushHourSolver & solver)
+	{
+		MoveList moves;
+		solver.Ordering(blockerOrder);
+		bool solved = solver.SolveRushHourRec(moves);
+		return Finish(solver, solved, moves);
+	}
+
+	// DFS in the order the moves are generated
+	SolveResult SolveDFS(RushHourSolver & solver)
+	{
+		MoveList moves;
+		solver.Ordering(naturalOrder);
+		bool solved = solver.SolveRushHourRec(moves);
+		return Finish(solver, solved, moves);
+	}
+
+	// same as SolveRushHour
+	SolveResult SolveBestFirst(RushHourSolver & solver)
+	{
+		MoveList moves;
+		bool solved = solver.SolveBestFirst(moves);
+		return Finish(solver, solved, moves);
+	}
+
+	SolveResult SolveBFS(RushHourSolver & solver)
+	{
+		MoveList moves;
+		bool solved = solver.SolveBreadthFirst(moves);
+		return Finish(solver, solved, moves);
+	}
+
+	// fewest cells moved, or the prices the solver was given (see MoveCost)
+	SolveResult SolveCheapest(RushHourSolver & solver)
+	{
+		MoveList moves;
+		bool solved = solver.SolveCheapest(moves);
+		return Finish(solver, solved, moves);
+	}
+
+	SolveResult SolveOptimal(RushHourSolver & solver)
+	{
+		MoveList moves;
+		bool solved = solver.SolveIterativeDeepening(moves);
+		return Finish(solver, solved, moves);
+	}
+
+	// the shared drivers of search.h, same limits as the solver's own searches
+	enum GenericDriver { genericIterativeDeepening, genericBreadthFirst, genericIDAStar };
+
+	SolveResult SolveGeneric(RushHourSolver & solver, GenericDriver driver)
+	{
+		RushHourDomain domain(solver, driver != genericBreadthFirst);
+		GenericSearch<RushHourDomain> search(domain);
+		std::chrono::steady_clock::time_point deadline = solver.Deadline();
+		CancellationToken token = solver.Cancellation();
+		search.Stop([deadline, token] {
+			return token.IsCancelled() || std::chrono::steady_clock::now() >= deadline;
+		});
+
+		SolveResult result;
+		bool solved = false;
+		switch (driver) {
+		case genericIterativeDeepening: solved = search.IterativeDeepening(result.moves); break;
+		case genericBreadthFirst:       solved = search.BreadthFirst(result.moves); break;
+		case genericIDAStar:            solved = search.IDAStar(result.moves); break;
+		}
+		result.nodes = search.Nodes();
+		solver.ToCarIds(result.moves);
+		if (solved)
+			result.status = statusSolved;
+		else if (search.Stopped())
+			result.status = token.IsCancelled() ? statusCancelled : statusTimedOut;
+		if (!solved)
+			result.moves.clear();
+		return result;
+	}
+
+	SolveResult SolveGenericIterativeDeepening(RushHourSolver & solver) { return SolveGeneric(solver, genericIterativeDeepening); }
+	SolveResult SolveGenericBreadthFirst(RushHourSolver & solver) { return SolveGeneric(solver, genericBreadthFirst); }
+	SolveResult SolveGenericIDAStar(RushHourSolver & solver) { return SolveGeneric(solver, genericIDAStar); }
+
+	// portfolios with the engines that did best on level.0 - level.hard
+	SolveResult SolvePortfolioOptimal(RushHourSolver & solver)
+	{
+		return SolvePortfolio(solver, { "optimal", "bfs" }, false, solver.Deadline(), solver.Cancellation());
+	}
+
+	SolveResult SolvePortfolioAny(RushHourSolver & solver)
+	{
+		return SolvePortfolio(solver, { "bestfirst", "ordered", "dfs", "bfs" }, true, solver.Deadline(), solver.Cancellation());
+	}
+
+	struct EngineEntry {
+		char const * name;
+		SolveEngine engine;
+		bool optimal;
+	};
+
+	EngineEntry const engines[] = {
+		{ "any",           SolveBestFirst,        false },
+		{ "bestfirst",     SolveBestFirst,        false },
+		{ "ordered",       SolveOrdered,          false },
+		{ "dfs",           SolveDFS,              false },
+		{ "optimal",       SolveOptimal,          true },
+		{ "bfs",           SolveBFS,              true },
+		{ "cheapest",      SolveCheapest,         false },
+		{ "portfolio",     SolvePortfolioOptimal, true },
+		{ "portfolio-any", SolvePortfolioAny,     false },
+		{ "generic-iddfs", SolveGenericIterativeDeepening, true },
+		{ "generic-bfs",   SolveGenericBreadthFirst,       true },
+		{ "generic-ida",   SolveGenericIDAStar,            true },
+	};
+}
+
+char const * StatusName(SolveStatus status)
+{
+	switch (status) {
+	case statusSolved:     return "solved";
+	case statusNoSolution: return "nosolution";
+	case statusTimedOut:   return "timeout";
+	case statusCancelled:  return "cancelled";
+	default:               return "undefined";
+	}
+}
+
+SolveEngine FindEngine(std::string const & name)
+{
+	for (EngineEntry const & entry : engines) {
+		if (name == entry.name) {
+			return entry.engine;
+		}
+	}
+	return nullptr;
+}
+
+std::vector<std::string> EngineNames()
+{
+	std::vector<std::string> names;
+	for (EngineEntry const & entry : engines) {
+		names.push_back(entry.name);
+	}
+	return names;
+}
+
+bool IsOptimalEngine(std::string const & name)
+{
+	for (EngineEntry const & entry : engines) {
+		if (name == entry.name) {
+			return entry.optimal;
+		}
+	}
+	return false;
+}
+
+SolveResult RunEngine(SolveEngine engine, RushHourSolver & solver, std::chrono::steady_clock::time_point deadline,
+                      CancellationToken const & cancel)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	solver.Deadline(deadline);
+	solver.Cancellation(cancel);
+	SolveResult result = engine(solver);
+	result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return result;
+}
+
+SolveResult SolvePortfolio(RushHourSolver const & solver, std::vector<std::string> const & engines, bool anySolution,
+                           std::chrono::steady_clock::time_point deadline, CancellationToken const & outerCancel)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	CancellationToken cancel;
+	std::mutex winnerLock;
+	std::condition_variable finished;
+	size_t running = 0;
+	bool decided = false;
+	SolveResult winner;
+	winner.status = statusTimedOut;
+
+	std::vector<std::thread> racers;
+	for (std::string const & name : engines) {
+		SolveEngine engine = FindEngine(name);
+		if (!engine) {
+			continue;
+		}
+		++running;
+		racers.push_back(std::thread([&, name, engine] {
+			RushHourSolver copy(solver);
+			SolveResult result = RunEngine(engine, copy, deadline, cancel);
+			result.engine = name;
+
+			// a complete search without a solution is just as conclusive as a solution
+			bool conclusive = result.status == statusNoSolution
+				|| (result.status == statusSolved && (anySolution || IsOptimalEngine(name)));
+
+			std::lock_guard<std::mutex> lock(winnerLock);
+			if (conclusive && !decided) {
+				decided = true;
+				winner = result;
+				cancel.Cancel();
+			}
+			--running;
+			finished.notify_all();
+		}));
+	}
+
+	// pass the caller's cancel on to the racers
+	{
+		std::unique_lock<std::mutex> lock(winnerLock);
+		while (running > 0) {
+			finished.wait_for(lock, std::chrono::milliseconds(10));
+			if (outerCancel.IsCancelled()) {
+				cancel.Cancel();
+			}
+		}
+	}
+	for (std::thread & racer : racers) {
+		racer.join();
+	}
+
+	if (!decided) {
+		winner.status = outerCancel.IsCancelled() ? statusCancelled : statusTimedOut;
+	}
+	winner.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return winner;
+}
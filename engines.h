@@ -0,0 +1,87 @@
+/*!
+* \file engines.h
+* \author Egemen Koku
+* \date 19 Oct 2026
+* \brief Interface of @b engines.cpp
+*
+* \copyright Digipen Institute of Technology
+*
+*/
+
+#ifndef ENGINES_H
+#define ENGINES_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include "rushhour.h"
+
+enum SolveStatus { statusSolved, statusNoSolution, statusTimedOut, statusCancelled };
+
+/**
+ * @brief Short name of a status, used by the daemon protocol
+ * @param status Status to be named
+ * @return Name of the status
+ */
+char const * StatusName(SolveStatus status);
+
+struct SolveResult {
+	MoveList moves = MoveList();
+	SolveStatus status = statusNoSolution;
+	unsigned long long nodes = 0;            // nodes searched
+	double seconds = 0;                      // time spent in the engine
+	size_t peakBytes = 0;                    // peak of the estimated search memory, see MemoryUsage
+	std::string engine = std::string();      // engine that produced the result
+};
+
+// An engine solves from the current state of an initialized solver
+typedef SolveResult (*SolveEngine)(RushHourSolver & solver);
+
+/**
+ * @brief Looks an engine up by name ("any", "optimal" ...)
+ * @param name Name of the engine
+ * @return The engine, nullptr if there is no such engine
+ */
+SolveEngine FindEngine(std::string const & name);
+
+/**
+ * @brief Names of all the engines
+ * @return Engine names
+ */
+std::vector<std::string> EngineNames();
+
+/**
+ * @brief Whether the engine only ever returns shortest solutions
+ * @param name Name of the engine
+ * @return Optimal or not, false for unknown engines
+ */
+bool IsOptimalEngine(std::string const & name);
+
+/**
+ * @brief Runs an engine on a solver with a deadline and times it
+ * @param engine Engine to be used
+ * @param solver Initialized solver (after InitCarLocations)
+ * @param deadline The engine gives up once it passes
+ * @param cancel The engine gives up soon after this is cancelled
+ * @return Moves, status and stats
+ */
+SolveResult RunEngine(SolveEngine engine, RushHourSolver & solver,
+                      std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max(),
+                      CancellationToken const & cancel = CancellationToken());
+
+/**
+ * @brief Races several engines on their own threads. The first conclusive result wins
+ *        (a solution from an optimal engine, any solution if anySolution is set, or a
+ *        complete search without a solution) and the other engines are cancelled.
+ * @param solver Initialized solver, every engine gets its own copy
+ * @param engines Names of the engines to race
+ * @param anySolution Accept the first solution of a non optimal engine too
+ * @param deadline Every engine gives up once it passes
+ * @param cancel Cancels every engine when cancelled
+ * @return Result of the winner, its name is in SolveResult::engine
+ */
+SolveResult SolvePortfolio(RushHourSolver const & solver, std::vector<std::string> const & engines, bool anySolution,
+                           std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max(),
+                           CancellationToken const & cancel = CancellationToken());
+
+#endif
@@ -0,0 +1,135 @@
+/*!
+* \file phases.cpp
+* \author Egemen Koku
+* \date 19 Oct 2026
+* \brief Impl of @b phases.cpp
+*
+* \copyright Digipen Institute of Technology
+*
+*/
+
+#include "phases.h"
+#include <algorithm>
+#include <iomanip>
+#include <map>
+
+namespace {
+	// JSON string with the quotes
+	std::string Quote(std::string const & text)
+	{
+		static char const hex[] = "0123456789abcdef";
+		std::string quoted = "\"";
+		for (char c : text) {
+			if (c == '"' || c == '\\') {
+				quoted.push_back('\\');
+				quoted.push_back(c);
+			}
+			else if (static_cast<unsigned char>(c) < 0x20) {
+				quoted.append("\\u00");
+				quoted.push_back(hex[static_cast<unsigned char>(c) >> 4]);
+				quoted.push_back(hex[static_cast<unsigned char>(c) & 0xf]);
+			}
+			else {
+				quoted.push_back(c);
+			}
+		}
+		quoted.push_back('"');
+		return quoted;
+	}
+}
+
+void PhaseTimeline::Record(PhaseEvent event, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end)
+{
+	std::lock_guard<std::mutex> guard(lock);
+	event.start = std::chrono::duration<double, std::micro>(begin - origin).count();
+	event.duration = std::chrono::duration<double, std::micro>(end - begin).count();
+	std::thread::id id = std::this_thread::get_id();
+	event.thread = static_cast<unsigned>(std::find(threads.begin(), threads.end(), id) - threads.begin());
+	if (event.thread == threads.size())
+		threads.push_back(id);
+	events.push_back(std::move(event));
+}
+
+std::vector<PhaseEvent> PhaseTimeline::Events() const
+{
+	std::lock_guard<std::mutex> guard(lock);
+	return events;
+}
+
+void PhaseTimeline::Clear()
+{
+	std::lock_guard<std::mutex> guard(lock);
+	events.clear();
+}
+
+void PhaseTimeline::WriteChromeTrace(std::ostream & os) const
+{
+	std::vector<PhaseEvent> recorded = Events();
+	std::ios::fmtflags flags = os.flags();
+	os << std::fixed << std::setprecision(3);
+	os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	for (size_t i = 0; i < recorded.size(); ++i) {
+		PhaseEvent const & event = recorded[i];
+		os << (i ? ",\n" : "\n") << "{\"name\":" << Quote(event.name) << ",\"cat\":" << Quote(event.category)
+		   << ",\"ph\":\"X\",\"ts\":" << event.start << ",\"dur\":" << event.duration
+		   << ",\"pid\":1,\"tid\":" << event.thread << ",\"args\":{";
+		for (size_t arg = 0; arg < event.args.size(); ++arg) {
+			os << (arg ? "," : "") << Quote(event.args[arg].first) << ':' << event.args[arg].second;
+		}
+		os << "}}";
+	}
+	os << "\n]}\n";
+	os.flags(flags);
+}
+
+void PhaseTimeline::WriteSummary(std::ostream & os) const
+{
+	// microseconds and count by category and name
+	std::map<std::pair<std::string, std::string>, std::pair<double, size_t>> totals;
+	for (PhaseEvent const & event : Events()) {
+		std::pair<double, size_t> & total = totals[std::make_pair(event.category, event.name)];
+		total.first += event.duration;
+		++total.second;
+	}
+	typedef std::pair<std::pair<std::string, std::string>, std::pair<double, size_t>> Total;
+	std::vector<Total> sorted(totals.begin(), totals.end());
+	std::sort(sorted.begin(), sorted.end(), [](Total const & lhs, Total const & rhs) {
+		return lhs.second.first > rhs.second.first;
+	});
+
+	std::ios::fmtflags flags = os.flags();
+	os << std::fixed << std::setprecision(3);
+	for (Total const & entry : sorted) {
+		os << std::left << std::setw(10) << entry.first.first << std::setw(24) << entry.first.second << std::right
+		   << std::setw(14) << entry.second.first / 1000 << " ms" << std::setw(8) << entry.second.second << "x\n";
+	}
+	os.flags(flags);
+}
+
+PhaseScope::PhaseScope(PhaseTimeline * timeline, char const * name, char const * category)
+: timeline(timeline)
+{
+	if (!timeline)
+		return;
+	event.name = name;
+	event.category = category;
+	begin = std::chrono::steady_clock::now();
+}
+
+PhaseScope::~PhaseScope()
+{
+	if (timeline)
+		timeline->Record(std::move(event), begin, std::chrono::steady_clock::now());
+}
+
+void PhaseScope::Arg(char const * key, unsigned long long value)
+{
+	if (timeline)
+		event.args.push_back(std::make_pair(std::string(key), std::to_string(value)));
+}
+
+void PhaseScope::Arg(char const * key, std::string const & value)
+{
+	if (timeline)
+		event.args.push_back(std::make_pair(std::string(key), Quote(value)));
+}
@@ -0,0 +1,126 @@
+/*!
+* \file phases.h
+* \author Egemen Koku
+* \date 19 Oct 2026
+* \brief Interface of @b phases.cpp - timeline of the phases of the solves
+*
+* \copyright Digipen Institute of Technology
+*
+*/
+
+#ifndef PHASES_H
+#define PHASES_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <ostream>
+
+// Phase on the timeline, times in microseconds since the timeline was created
+struct PhaseEvent {
+	std::string name;
+	std::string category;                    // level, phase, search or iteration
+	double start = 0;
+	double duration = 0;
+	unsigned thread = 0;                     // threads are numbered in the order they first record
+	std::vector<std::pair<std::string, std::string>> args = std::vector<std::pair<std::string, std::string>>(); // values are JSON already
+};
+
+/*
+ * Phases of any number of solves, from any number of threads: parsing, initialization,
+ * the searches with every iteration of iterative deepening, path reconstruction and
+ * validation. Only a solver that was handed one records, and it only reads the clock
+ * at the start and the end of a phase, never per node.
+ */
+class PhaseTimeline {
+private:
+	std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+	std::vector<PhaseEvent> events = std::vector<PhaseEvent>();
+	std::vector<std::thread::id> threads = std::vector<std::thread::id>();
+	mutable std::mutex lock;
+
+public:
+	PhaseTimeline() : lock() {}
+
+	PhaseTimeline(PhaseTimeline const &) = delete;
+	PhaseTimeline & operator=(PhaseTimeline const &) = delete;
+
+	/**
+	 * @brief Adds a finished phase, the thread is the calling one
+	 * @param event Phase with its name, category, times and arguments
+	 * @param begin When the phase started
+	 * @param end When it ended
+	 */
+	void Record(PhaseEvent event, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end);
+
+	/**
+	 * @brief Copy of the phases recorded so far, in the order they ended
+	 * @return Phases
+	 */
+	std::vector<PhaseEvent> Events() const;
+
+	/**
+	 * @brief Drops every phase, the times still count from the creation
+	 */
+	void Clear();
+
+	/**
+	 * @brief Writes the phases as Chrome trace events (complete events of the JSON object
+	 *        format), for chrome://tracing or Perfetto
+	 * @param os Stream to write into
+	 */
+	void WriteChromeTrace(std::ostream & os) const;
+
+	/**
+	 * @brief Writes the total time and the count of every phase name, slowest first
+	 * @param os Stream to write into
+	 */
+	void WriteSummary(std::ostream & os) const;
+};
+
+/*
+ * Times the scope it lives in and records it when it is left, exceptions included.
+ * Does nothing, not even reading the clock, without a timeline.
+ */
+class PhaseScope {
+private:
+	PhaseTimeline * timeline;
+	PhaseEvent event = PhaseEvent();
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::time_point();
+
+public:
+	/**
+	 * @brief Constructor of the class, starts the phase
+	 * @param timeline Timeline to record into, nullptr for none
+	 * @param name Name of the phase
+	 * @param category Category of the phase
+	 */
+	PhaseScope(PhaseTimeline * timeline, char const * name, char const * category = "phase");
+
+	/**
+	 * @brief Destructor of the class, ends the phase and records it
+	 */
+	~PhaseScope();
+
+	PhaseScope(PhaseScope const &) = delete;
+	PhaseScope & operator=(PhaseScope const &) = delete;
+
+	/**
+	 * @brief Adds a number to the arguments of the phase
+	 * @param key Name of the argument
+	 * @param value Its value
+	 */
+	void Arg(char const * key, unsigned long long value);
+
+	/**
+	 * @brief Adds a string to the arguments of the phase
+	 * @param key Name of the argument
+	 * @param value Its value
+	 */
+	void Arg(char const * key, std::string const & value);
+};
+
+#endif
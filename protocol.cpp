@@ -0,0 +1,118 @@
+/*!
+* \file protocol.cpp
+* \author Egemen Koku
+* \date 19 Oct 2026
+* \brief Impl of @b protocol.cpp
+*
+* \copyright Digipen Institute of Technology
+*
+*/
+
+#include "protocol.h"
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+bool LineReader::ReadLine(std::string & line)
+{
+	line.clear();
+	for (;;) {
+		std::vector<char>::iterator first = buffer.begin() + static_cast<std::ptrdiff_t>(begin);
+		std::vector<char>::iterator last = buffer.begin() + static_cast<std::ptrdiff_t>(end);
+		std::vector<char>::iterator newLine = std::find(first, last, '\n');
+		line.append(first, newLine);
+		if (newLine != last) {
+			begin = static_cast<size_t>(newLine - buffer.begin()) + 1;
+			return true;
+		}
+
+		begin = end = 0;
+		ssize_t count = read(fd, buffer.data(), buffer.size());
+		if (count < 0 && errno == EINTR) {
+			continue;
+		}
+		if (count <= 0) {
+			// last line without a new line still counts
+			return !line.empty();
+		}
+		end = static_cast<size_t>(count);
+	}
+}
+
+bool WriteAll(int fd, std::string const & data)
+{
+	size_t written = 0;
+	while (written < data.size()) {
+		ssize_t count = write(fd, data.data() + written, data.size() - written);
+		if (count < 0 && errno == EINTR) {
+			continue;
+		}
+		if (count <= 0) {
+			return false;
+		}
+		written += static_cast<size_t>(count);
+	}
+	return true;
+}
+
+char const * DirectionName(Direction d)
+{
+	switch (d) {
+	case up:    return "up";
+	case left:  return "left";
+	case down:  return "down";
+	case right: return "right";
+	default:    return "undefined";
+	}
+}
+
+namespace {
+	bool SocketAddress(std::string const & path, sockaddr_un & address)
+	{
+		std::memset(&address, 0, sizeof(address));
+		address.sun_family = AF_UNIX;
+		if (path.size() >= sizeof(address.sun_path)) {
+			return false;
+		}
+		std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+		return true;
+	}
+}
+
+int ListenUnixSocket(std::string const & path)
+{
+	sockaddr_un address;
+	if (!SocketAddress(path, address)) {
+		return -1;
+	}
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0) {
+		return -1;
+	}
+	unlink(path.c_str());
+	if (bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || listen(fd, 64) != 0) {
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+int ConnectUnixSocket(std::string const & path)
+{
+	sockaddr_un address;
+	if (!SocketAddress(path, address)) {
+		return -1;
+	}
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0) {
+		return -1;
+	}
+	if (connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
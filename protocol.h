@@ -0,0 +1,77 @@
+/*!
+* \file protocol.h
+* \author Egemen Koku
+* \date 19 Oct 2026
+* \brief Interface of @b protocol.cpp - line protocol shared by rhdaemon and rhclient (POSIX only)
+*
+* \copyright Digipen Institute of Technology
+*
+* One request per line:
+*   <id> <engine> <deadline in ms, 0 = none> <level file>
+* One response line per request, in the order they complete:
+*   <id> <status> <engine> <steps> <microseconds> <nodes> [<car> <direction> <positions>]...
+*   <id> error <message>
+*/
+
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <string>
+#include <vector>
+#include "rushhour.h"
+
+/*
+ * Reads lines from a file descriptor through a buffer
+ */
+class LineReader {
+private:
+	int fd;
+	std::vector<char> buffer = std::vector<char>(1 << 16);
+	size_t begin = 0;                        // first unread byte
+	size_t end = 0;                          // one past the last read byte
+
+public:
+	/**
+	 * @brief Constructor of the class
+	 * @param fd File descriptor to read from
+	 */
+	explicit LineReader(int fd) : fd(fd) {}
+
+	/**
+	 * @brief Reads the next line without the new line character
+	 * @param line Line to be filled
+	 * @return false on end of file or error
+	 */
+	bool ReadLine(std::string & line);
+};
+
+/**
+ * @brief Writes the whole string, retrying short writes
+ * @param fd File descriptor to write into
+ * @param data Data to be written
+ * @return false if the other end is gone
+ */
+bool WriteAll(int fd, std::string const & data);
+
+/**
+ * @brief Name of a direction without the trailing space operator<< adds
+ * @param d Direction to be named
+ * @return Name of the direction
+ */
+char const * DirectionName(Direction d);
+
+/**
+ * @brief Opens a listening unix domain socket, replacing a stale socket file
+ * @param path Path of the socket
+ * @return Socket, -1 on error
+ */
+int ListenUnixSocket(std::string const & path);
+
+/**
+ * @brief Connects to a unix domain socket
+ * @param path Path of the socket
+ * @return Socket, -1 on error
+ */
+int ConnectUnixSocket(std::string const & path);
+
+#endif
@@ -0,0 +1,109 @@
+/*!
+* \file rhbench.cpp
+* \author Egemen Koku
+* \date 19 Oct 2026
+* \brief Micro-benchmarks of the solver primitives on the given levels
+*
+* \copyright Digipen Institute of Technology
+*
+* Options before the levels:
+*   -samples <n>       timed samples of every primitive (15)
+*   -time <ms>         shortest time of a sample (10)
+*   -boards <n>        boards taken from every level (32)
+*   -nocounters        don't read the hardware counters
+*   -nosearch          don't time whole searches of the levels
+* and the switches of those searches (see SearchPolicy), for comparing them:
+*   -noclosedlist      without the closed list
+*   -nopartialorder    every order of the commuting moves
+*   -blocker           blocker order instead of the natural one
+*   -hashcheck         recompute the hash after every move
+*   -filter <states>   Bloom filter visited set of depth first search
+*/
+
+#include "benchmark.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+namespace {
+	char const * const eventNames[hardwareEvents] = { "cycles", "instr", "br-miss", "cache-miss" };
+}
+
+int main(int argc, char ** argv)
+{
+	BenchOptions options;
+	int first = 1;
+	try {
+		for (; first < argc && argv[first][0] == '-'; ++first) {
+			std::string option = argv[first];
+			if (option == "-nocounters")
+				options.counters = false;
+			else if (option == "-nosearch")
+				options.searches = false;
+			else if (option == "-noclosedlist")
+				options.closedList = false;
+			else if (option == "-nopartialorder")
+				options.partialOrder = false;
+			else if (option == "-blocker")
+				options.ordering = blockerOrder;
+			else if (option == "-hashcheck")
+				options.hashCheck = true;
+			else if (first + 1 == argc)
+				break;
+			else if (option == "-samples")
+				options.samples = static_cast<unsigned>(std::stoul(argv[++first]));
+			else if (option == "-time")
+				options.sampleTime = std::stod(argv[++first]) / 1000;
+			else if (option == "-boards")
+				options.boards = std::stoul(argv[++first]);
+			else if (option == "-filter")
+				options.filterStates = std::stoul(argv[++first]);
+			else
+				break;
+		}
+	}
+	catch (std::exception const &) {
+		first = argc;
+	}
+	if (first >= argc || argv[first][0] == '-') {
+		std::cout << "Usage ./" << argv[0] << " <optional -samples n> <optional -time ms> <optional -boards n> <optional -nocounters> <optional -nosearch>\n"
+		          << "       <optional -noclosedlist> <optional -nopartialorder> <optional -blocker> <optional -hashcheck> <optional -filter states>\n"
+		          << "       <level> <more levels>\n";
+		return 1;
+	}
+
+	try {
+		for (int level = first; level < argc; ++level) {
+			SolverBenchmark benchmark(argv[level], options);
+			std::cout << argv[level] << ": " << benchmark.Boards() << " boards, " << benchmark.States() << " states in the closed list\n";
+			std::cout << std::left << std::setw(40) << "primitive" << std::right;
+			for (char const * column : { "median", "mean", "min", "max", "stddev" }) {
+				std::cout << std::setw(14) << column;
+			}
+			for (unsigned event = 0; event < hardwareEvents; ++event) {
+				if (benchmark.Counted(static_cast<HardwareEvent>(event)))
+					std::cout << std::setw(12) << eventNames[event];
+			}
+			std::cout << "   (ns and counts per operation)\n";
+
+			for (BenchStats const & stats : benchmark.Run()) {
+				std::cout << std::left << std::setw(40) << stats.name << std::right << std::fixed << std::setprecision(2);
+				for (double value : { stats.median, stats.mean, stats.min, stats.max, stats.deviation }) {
+					std::cout << std::setw(14) << value;
+				}
+				for (unsigned event = 0; event < hardwareEvents; ++event) {
+					if (stats.counted[event])
+						std::cout << std::setw(12) << stats.perEvent[event];
+				}
+				std::cout << '\n';
+				std::cout.unsetf(std::ios::fixed);
+			}
+			std::cout << '\n';
+		}
+	}
+	catch (char const * msg) {
+		std::cerr << " in rhbench " << msg << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,126 @@
+/*!
+* \file rhclient.cpp
+* \author Egemen Koku
+* \date 19 Oct 2026
+* \brief Replays a corpus against rhdaemon and reports latency percentiles
+*
+* \copyright Digipen Institute of Technology
+*
+* Corpus has one request per line without the id:
+*   <engine> <deadline in ms, 0 = none> <level file>
+*/
+
+#include "protocol.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+#include <csignal>
+#include <unistd.h>
+#include <sys/socket.h>
+
+typedef std::chrono::steady_clock Clock;
+
+int main(int argc, char ** argv)
+{
+	std::string socketPath;
+	std::string corpusFile;
+	unsigned repeat = 1;
+	for (int i = 1; i + 1 < argc; i += 2) {
+		std::string arg(argv[i]);
+		if (arg == "--socket") { socketPath = argv[i + 1]; }
+		else if (arg == "--corpus") { corpusFile = argv[i + 1]; }
+		else if (arg == "--repeat") { repeat = static_cast<unsigned>(std::max(1, std::atoi(argv[i + 1]))); }
+	}
+	if (socketPath.empty() || corpusFile.empty()) {
+		std::cout << "Usage ./" << argv[0] << " --socket <path> --corpus <file> <optional --repeat N>\n";
+		return 1;
+	}
+
+	std::vector<std::string> corpus;
+	std::ifstream in(corpusFile);
+	std::string line;
+	while (std::getline(in, line)) {
+		if (!line.empty() && line[0] != '#') {
+			corpus.push_back(line);
+		}
+	}
+
+	int fd = ConnectUnixSocket(socketPath);
+	if (fd < 0) {
+		std::cerr << "cannot connect to " << socketPath << std::endl;
+		return 1;
+	}
+	std::signal(SIGPIPE, SIG_IGN);
+
+	size_t total = corpus.size() * repeat;
+	std::vector<Clock::time_point> sent(total);
+	std::mutex sentLock;
+
+	Clock::time_point start = Clock::now();
+
+	// everything is sent up front, the daemon answers in completion order
+	std::thread sender([&] {
+		std::string batch;
+		size_t first = 0;                    // first id in the batch
+		for (size_t id = 0; id < total; ++id) {
+			batch += std::to_string(id) + " " + corpus[id % corpus.size()] + "\n";
+			if (batch.size() > 4096 || id + 1 == total) {
+				{
+					std::lock_guard<std::mutex> lock(sentLock);
+					std::fill(sent.begin() + static_cast<std::ptrdiff_t>(first), sent.begin() + static_cast<std::ptrdiff_t>(id + 1), Clock::now());
+				}
+				WriteAll(fd, batch);
+				batch.clear();
+				first = id + 1;
+			}
+		}
+		shutdown(fd, SHUT_WR);
+	});
+
+	LineReader reader(fd);
+	std::vector<double> latencies;
+	std::map<std::string, unsigned> statuses;
+	while (latencies.size() < total && reader.ReadLine(line)) {
+		Clock::time_point now = Clock::now();
+		std::istringstream response(line);
+		size_t id = 0;
+		std::string status;
+		response >> id >> status;
+		++statuses[status];
+		std::lock_guard<std::mutex> lock(sentLock);
+		if (id < total) {
+			latencies.push_back(std::chrono::duration<double, std::milli>(now - sent[id]).count());
+		}
+	}
+	double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+	sender.join();
+	close(fd);
+
+	if (latencies.empty()) {
+		std::cout << "no responses\n";
+		return 1;
+	}
+	std::sort(latencies.begin(), latencies.end());
+	auto percentile = [&latencies](double p) {
+		size_t rank = static_cast<size_t>(std::ceil(p * static_cast<double>(latencies.size())));
+		return latencies[std::max<size_t>(rank, 1) - 1];
+	};
+
+	std::cout << "Requests " << latencies.size() << " of " << total << " in " << elapsed << " s ("
+	          << static_cast<double>(latencies.size()) / elapsed << " per second)\n";
+	for (std::map<std::string, unsigned>::const_iterator iter = statuses.begin(); iter != statuses.end(); ++iter) {
+		std::cout << "  " << iter->first << " " << iter->second << "\n";
+	}
+	std::cout << "Latency ms p50 " << percentile(0.5) << " p90 " << percentile(0.9) << " p99 " << percentile(0.99)
+	          << " max " << latencies.back() << "\n";
+	return latencies.size() == total ? 0 : 1;
+}
@@ -0,0 +1,52 @@
+/*!
+* \file rhcount.cpp
+* \author Egemen Koku
+* \date 19 Oct 2026
+* \brief Counts the shortest solutions of a level and lists as many of them as asked for
+*
+* \copyright Digipen Institute of Technology
+*
+*/
+
+#include "solutions.h"
+#include <iostream>
+#include <string>
+#include <chrono>
+
+int main(int argc, char ** argv)
+{
+	if (argc != 2 && argc != 3) {
+		std::cout << "Usage ./" << argv[0] << " <level> <optional number of solutions to list>\n";
+		return 1;
+	}
+
+	try {
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		OptimalSolutions solutions(argv[1]);
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		if (!solutions.Solvable()) {
+			std::cout << "Rush hour solution couldn't found\n";
+			std::cout << "States explored = " << solutions.States() << '\n';
+			return 0;
+		}
+		std::cout << "Number of steps = " << solutions.Length() << '\n';
+		std::cout << "Number of optimal solutions = " << solutions.Count().ToString() << '\n';
+		std::cout << "States explored = " << solutions.States() << '\n';
+		std::cout << "Time elapsed " << elapsed.count() << '\n';
+
+		unsigned long long list = argc == 3 ? std::stoull(argv[2]) : 0;
+		MoveList solution;
+		for (unsigned long long i = 0; i < list && solutions.Next(solution); ++i) {
+			std::cout << "Solution " << i + 1 << ':';
+			for (std::tuple<unsigned, Direction, unsigned> const & move : solution) {
+				std::cout << ' ' << std::get<0>(move) << ' ' << std::get<1>(move) << std::get<2>(move) << ',';
+			}
+			std::cout << '\n';
+		}
+	}
+	catch (char const * msg) {
+		std::cerr << " in rhcount " << msg << std::endl;
+		return 1;
+	}
+	return 0;
+}
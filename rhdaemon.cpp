@@ -0,0 +1,281 @@
+/*!
+* \file rhdaemon.cpp
+* \author Egemen Koku
+* \date 19 Oct 2026
+* \brief Long running solver. Reads pipelined requests from stdin or a unix domain
+*        socket and streams the results back as they complete. See protocol.h.
+*
+* \copyright Digipen Institute of Technology
+*
+*/
+
+#include "rushhour.h"
+#include "engines.h"
+#include "protocol.h"
+#include <iostream>
+#include <sstream>
+#include <exception>
+#include <string>
+#include <deque>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/socket.h>
+
+typedef std::chrono::steady_clock Clock;
+
+/*
+ * One client. Responses of different workers are serialized by the write lock.
+ */
+class Connection {
+private:
+	int in;
+	int out;
+	std::mutex writeLock;
+	std::mutex pendingLock;
+	std::condition_variable idle;
+	unsigned pending = 0;                    // requests still in the pool
+
+public:
+	Connection(int in, int out) : in(in), out(out) {}
+
+	int In() const { return in; }
+
+	void Send(std::string const & line)
+	{
+		std::lock_guard<std::mutex> lock(writeLock);
+		WriteAll(out, line);
+	}
+
+	void Started()
+	{
+		std::lock_guard<std::mutex> lock(pendingLock);
+		++pending;
+	}
+
+	void Finished()
+	{
+		std::lock_guard<std::mutex> lock(pendingLock);
+		if (--pending == 0) {
+			idle.notify_all();
+		}
+	}
+
+	// waits until every request of this connection is answered
+	void WaitIdle()
+	{
+		std::unique_lock<std::mutex> lock(pendingLock);
+		idle.wait(lock, [this] { return pending == 0; });
+	}
+};
+
+struct Job {
+	Connection * connection;
+	std::string id;
+	std::string engineName;
+	SolveEngine engine;
+	std::string filename;
+	Clock::time_point deadline;
+	Clock::time_point received;
+};
+
+/*
+ * Fixed set of worker threads plus the parsed levels. A level is parsed once and
+ * every request after that starts from a copy of the initialized solver.
+ */
+class SolverPool {
+private:
+	std::vector<std::thread> workers;
+	std::deque<Job> jobs;
+	std::mutex jobsLock;
+	std::condition_variable ready;
+	bool stopping = false;
+
+	std::map<std::string, RushHourSolver> levels;
+	std::mutex levelsLock;
+	size_t memoryBudget;                     // per request, 0 for no limit
+
+	RushHourSolver Level(std::string const & filename)
+	{
+		{
+			std::lock_guard<std::mutex> lock(levelsLock);
+			std::map<std::string, RushHourSolver>::const_iterator iter = levels.find(filename);
+			if (iter != levels.end()) {
+				return iter->second;
+			}
+		}
+		RushHourSolver solver(filename);
+		solver.InitCarLocations();
+		std::lock_guard<std::mutex> lock(levelsLock);
+		levels.insert(std::make_pair(filename, solver));
+		return solver;
+	}
+
+	void Run(Job const & job)
+	{
+		std::ostringstream response;
+		try {
+			RushHourSolver solver = Level(job.filename);
+			solver.MemoryBudget(memoryBudget);
+			SolveResult result = RunEngine(job.engine, solver, job.deadline);
+			long long micros = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - job.received).count();
+			// portfolios name the engine that won
+			std::string engine = result.engine.empty() ? job.engineName : result.engine;
+			response << job.id << " " << StatusName(result.status) << " " << engine << " " << result.moves.size() << " " << micros << " " << result.nodes;
+			for (std::tuple<unsigned, Direction, unsigned> const & m : result.moves) {
+				response << " " << std::get<0>(m) << " " << DirectionName(std::get<1>(m)) << " " << std::get<2>(m);
+			}
+		}
+		catch (char const * msg) {
+			response.str("");
+			response << job.id << " error " << msg;
+		}
+		// anything else thrown on a worker would end the whole daemon
+		catch (std::exception const & e) {
+			response.str("");
+			response << job.id << " error " << e.what();
+		}
+		catch (...) {
+			response.str("");
+			response << job.id << " error unknown failure";
+		}
+		response << '\n';
+		job.connection->Send(response.str());
+		job.connection->Finished();
+	}
+
+	void Work()
+	{
+		for (;;) {
+			std::unique_lock<std::mutex> lock(jobsLock);
+			ready.wait(lock, [this] { return stopping || !jobs.empty(); });
+			if (jobs.empty()) {
+				return;
+			}
+			Job job = jobs.front();
+			jobs.pop_front();
+			lock.unlock();
+			Run(job);
+		}
+	}
+
+public:
+	SolverPool(unsigned threads, size_t memoryBudget) : memoryBudget(memoryBudget)
+	{
+		for (unsigned i = 0; i < threads; ++i) {
+			workers.push_back(std::thread(&SolverPool::Work, this));
+		}
+	}
+
+	~SolverPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(jobsLock);
+			stopping = true;
+		}
+		ready.notify_all();
+		for (std::thread & worker : workers) {
+			worker.join();
+		}
+	}
+
+	void Submit(Job const & job)
+	{
+		job.connection->Started();
+		{
+			std::lock_guard<std::mutex> lock(jobsLock);
+			jobs.push_back(job);
+		}
+		ready.notify_one();
+	}
+};
+
+// Reads requests until the client closes its end, then waits for the answers
+void Serve(SolverPool & pool, Connection & connection)
+{
+	LineReader reader(connection.In());
+	std::string line;
+	while (reader.ReadLine(line)) {
+		std::istringstream request(line);
+		Job job;
+		long long deadlineMs = 0;
+		if (!(request >> job.id)) {
+			continue; // empty line
+		}
+		if (!(request >> job.engineName >> deadlineMs) || !std::getline(request >> std::ws, job.filename) || job.filename.empty()) {
+			connection.Send(job.id + " error expected <id> <engine> <deadline ms> <level file>\n");
+			continue;
+		}
+		job.engine = FindEngine(job.engineName);
+		if (!job.engine) {
+			connection.Send(job.id + " error unknown engine " + job.engineName + "\n");
+			continue;
+		}
+		job.connection = &connection;
+		job.received = Clock::now();
+		job.deadline = deadlineMs > 0 ? job.received + std::chrono::milliseconds(deadlineMs) : Clock::time_point::max();
+		pool.Submit(job);
+	}
+	connection.WaitIdle();
+}
+
+int main(int argc, char ** argv)
+{
+	unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+	std::string socketPath;
+	size_t memoryBudget = 0;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg(argv[i]);
+		if (arg == "--threads" && i + 1 < argc) {
+			threads = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+		}
+		else if (arg == "--socket" && i + 1 < argc) {
+			socketPath = argv[++i];
+		}
+		else if (arg == "--memory" && i + 1 < argc) {
+			memoryBudget = static_cast<size_t>(std::max(0, std::atoi(argv[++i]))) << 20;
+		}
+		else {
+			std::cerr << "Usage ./" << argv[0] << " <optional --threads N> <optional --socket path (default stdin/stdout)> <optional --memory MB per request>\n";
+			std::cerr << "Engines:";
+			for (std::string const & name : EngineNames()) {
+				std::cerr << " " << name;
+			}
+			std::cerr << "\n";
+			return 1;
+		}
+	}
+
+	// a client hanging up must not kill the daemon
+	std::signal(SIGPIPE, SIG_IGN);
+
+	SolverPool pool(threads, memoryBudget);
+
+	if (socketPath.empty()) {
+		Connection connection(STDIN_FILENO, STDOUT_FILENO);
+		Serve(pool, connection);
+		return 0;
+	}
+
+	int listener = ListenUnixSocket(socketPath);
+	if (listener < 0) {
+		std::cerr << "cannot listen on " << socketPath << std::endl;
+		return 1;
+	}
+	for (;;) {
+		int client = accept(listener, nullptr, nullptr);
+		if (client < 0) {
+			continue;
+		}
+		std::thread([&pool, client] {
+			Connection connection(client, client);
+			Serve(pool, connection);
+			close(client);
+		}).detach();
+	}
+}
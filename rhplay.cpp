@@ -0,0 +1,107 @@
+/*!
+* \file rhplay.cpp
+* \author Egemen Koku
+* \date 19 Oct 2026
+* \brief Plays a level from the console with hints from a RushHourSession
+*
+* \copyright Digipen Institute of Technology
+*
+* Commands, one per line:
+*   move <car> <up|left|down|right> <positions>
+*   hint
+*   distance
+*   solution
+*   board
+*/
+
+#include "session.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <chrono>
+
+namespace {
+	Direction ParseDirection(std::string const & name)
+	{
+		if (name == "up")    return up;
+		if (name == "left")  return left;
+		if (name == "down")  return down;
+		if (name == "right") return right;
+		return undefined;
+	}
+
+	void PrintBoard(ParkingLotBoard const & board)
+	{
+		for (unsigned i = 0; i < board.height; ++i) {
+			for (unsigned j = 0; j < board.width; ++j) {
+				std::cout << board.cells[i * board.width + j] << ' ';
+			}
+			std::cout << '\n';
+		}
+	}
+}
+
+int main(int argc, char ** argv)
+{
+	if (argc != 2 && argc != 3) {
+		std::cout << "Usage ./" << argv[0] << " <level> <optional max states to explore>\n";
+		return 1;
+	}
+
+	try {
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		RushHourSession session = argc == 3 ? RushHourSession(argv[1], std::stoul(argv[2])) : RushHourSession(argv[1]);
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		std::cout << "States explored = " << session.States() << (session.Explored() ? "" : " (too many, solving as we go)") << '\n';
+		std::cout << "Time elapsed " << elapsed.count() << '\n';
+
+		std::string line;
+		while (std::getline(std::cin, line)) {
+			std::istringstream in(line);
+			std::string command;
+			in >> command;
+			if (command == "move") {
+				unsigned car = 0, positions = 0;
+				std::string direction;
+				in >> car >> direction >> positions;
+				bool played = session.Play(RushHourSession::Move(car, ParseDirection(direction), positions));
+				std::cout << (played ? (session.IsSolved() ? "solved" : "ok") : "illegal move") << '\n';
+			}
+			else if (command == "hint") {
+				RushHourSession::Move move;
+				if (session.Hint(move))
+					std::cout << std::get<0>(move) << ' ' << std::get<1>(move) << std::get<2>(move) << '\n';
+				else
+					std::cout << (session.IsSolved() ? "solved" : "no hint") << '\n';
+			}
+			else if (command == "distance") {
+				unsigned distance = session.Distance();
+				if (distance == RushHourSession::noSolution)
+					std::cout << "no solution\n";
+				else
+					std::cout << distance << '\n';
+			}
+			else if (command == "solution") {
+				MoveList solution;
+				if (session.Solution(solution)) {
+					for (std::tuple<unsigned, Direction, unsigned> const & move : solution) {
+						std::cout << std::get<0>(move) << ' ' << std::get<1>(move) << std::get<2>(move) << '\n';
+					}
+				}
+				std::cout << "Number of steps = " << solution.size() << '\n';
+			}
+			else if (command == "board") {
+				PrintBoard(session.Board());
+			}
+			else if (!command.empty()) {
+				std::cout << "unknown command " << command << '\n';
+			}
+			std::cout.flush();
+		}
+	}
+	catch (char const * msg) {
+		std::cerr << " in rhplay " << msg << std::endl;
+		return 1;
+	}
+	return 0;
+}
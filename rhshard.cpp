@@ -0,0 +1,63 @@
+/*!
+* \file rhshard.cpp
+* \author Egemen Koku
+* \date 19 Oct 2026
+* \brief Solves a level with a breadth-first search split over worker processes (POSIX only)
+*
+* \copyright Digipen Institute of Technology
+*
+*/
+
+#include "shard.h"
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <csignal>
+
+int main(int argc, char ** argv)
+{
+	if (argc != 2 && argc != 3 && argc != 4) {
+		std::cout << "Usage ./" << argv[0] << " <level> <optional number of workers> <optional time limit in ms>\n";
+		return 1;
+	}
+	// a worker that died shows up as an error, not as a signal
+	std::signal(SIGPIPE, SIG_IGN);
+
+	try {
+		unsigned shards = argc >= 3 ? static_cast<unsigned>(std::stoul(argv[2])) : 4;
+		if (shards == 0)
+			shards = 1;
+		RushHourSolver solver(argv[1]);
+		solver.InitCarLocations();
+		if (argc == 4)
+			solver.Deadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(std::stoul(argv[3])));
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		ShardPipes transport(shards);
+		ShardedSearch search(solver, transport);
+		MoveList solution;
+		bool solved = search.Solve(solution);
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+		if (solved) {
+			for (std::tuple<unsigned, Direction, unsigned> const & move : solution) {
+				std::cout << std::get<0>(move) << ' ' << std::get<1>(move) << std::get<2>(move) << '\n';
+			}
+			std::cout << "Number of steps = " << solution.size() << '\n';
+		}
+		else if (search.Stopped()) {
+			std::cout << "Rush hour search stopped after " << search.Layers() << " layers\n";
+		}
+		else {
+			std::cout << "Rush hour solution couldn't found\n";
+		}
+		std::cout << "Workers = " << shards << '\n';
+		std::cout << "States explored = " << search.States() << '\n';
+		std::cout << "Time elapsed " << elapsed.count() << '\n';
+	}
+	catch (char const * msg) {
+		std::cerr << " in rhshard " << msg << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,225 @@
+/*!
+* \file rhtest.cpp
+* \author Egemen Koku
+* \date 19 Oct 2026
+* \brief Regression tests of the solver, run from the directory of the levels
+*
+* \copyright Digipen Institute of Technology
+*
+* Prints every failed check and returns 1 if there was one.
+*/
+
+#include "rushhour.h"
+#include "validator.h"
+#include "session.h"
+#include "engines.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+namespace {
+	unsigned failures = 0;
+
+	void Expect(bool condition, std::string const & what)
+	{
+		if (!condition) {
+			std::cout << "FAILED " << what << '\n';
+			++failures;
+		}
+	}
+
+	typedef bool (RushHourSolver::*Solve)(MoveList & solution);
+
+	// level.stuck can't be solved: car 3 always covers the row of car 4, which keeps car 2
+	// in the exit lane. level.free has the same cars in the same reading order, so its
+	// packed state means the same to the solver of level.stuck.
+	void UnsolvableThenSolvable(std::string const & name, Solve solve)
+	{
+		RushHourSolver free("level.free");
+		free.InitCarLocations();
+		RushHourSolver solver("level.stuck");
+		solver.InitCarLocations();
+
+		MoveList moves;
+		Expect(!(solver.*solve)(moves), name + ": level.stuck solved");
+		Expect(solver.Unsolvable(), name + ": level.stuck not proved unsolvable");
+
+		solver.Unpack(free.Pack());
+		Expect(!solver.Unsolvable(), name + ": Unsolvable kept after loading level.free");
+		moves.clear();
+		Expect((solver.*solve)(moves), name + ": level.free not solved after level.stuck");
+		Expect(!solver.Unsolvable() && !solver.TimedOut(), name + ": level.free stopped");
+		SolutionValidator validator;
+		Expect(validator.Validate(free.Board(), moves).result == validSolution, name + ": solution of level.free invalid");
+	}
+
+	// the solutions are by car number, makeMove takes them the same way. The main car of
+	// level.hard has index 0 but another number.
+	void ReplaySolution()
+	{
+		RushHourSolver solver("level.hard");
+		solver.InitCarLocations();
+		MoveList moves;
+		Expect(solver.SolveIterativeDeepening(moves), "replay: level.hard not solved");
+
+		RushHourSolver replay("level.hard");
+		replay.InitCarLocations();
+		for (std::tuple<unsigned, Direction, unsigned> const & move : moves) {
+			replay.makeMove(move);
+		}
+		Expect(replay.IsSolved(), "replay: makeMove with the car numbers of the solution didn't solve level.hard");
+	}
+
+	typedef std::tuple<unsigned, Direction, unsigned> Step;
+
+	// every move up to the failing one is applied, that one is not
+	void ExpectReport(ParkingLotBoard const & board, MoveList const & moves, ValidationResult result, unsigned failedMove, std::string const & what)
+	{
+		SolutionValidator validator;
+		ValidationReport report = validator.Validate(board, moves);
+		Expect(report.result == result, "validator: " + what + " gave " + ValidationMessage(report.result));
+		Expect(report.failedMove == failedMove, "validator: " + what + " failed at move " + std::to_string(report.failedMove));
+	}
+
+	// level.free:  0 0 0 0 2      car 1 goes right, the shortest solution is
+	//              1 1 3 0 2      2 down 2, 3 down 1, 1 right 3
+	//              4 4 3 0 0
+	//              0 5 3 0 0
+	//              0 5 0 0 0
+	void IllegalMoves()
+	{
+		ParkingLotBoard board = RushHourSolver("level.free").Board();
+		ExpectReport(board, { Step(2, down, 2), Step(3, down, 1), Step(1, right, 3) }, validSolution, 0, "solution");
+		ExpectReport(board, { Step(3, down, 1) }, notSolved, 0, "car 1 left in");
+		ExpectReport(board, { Step(3, down, 1), Step(7, up, 1) }, unknownCar, 1, "car 7");
+		ExpectReport(board, { Step(3, down, 1), Step(1, up, 1) }, wrongDirection, 1, "horizontal car 1 up");
+		ExpectReport(board, { Step(3, down, 1), Step(2, left, 1) }, wrongDirection, 1, "vertical car 2 left");
+		ExpectReport(board, { Step(2, up, 1) }, outOfParkingLot, 0, "car 2 up off the top row");
+		ExpectReport(board, { Step(3, down, 1), Step(2, down, 4) }, outOfParkingLot, 1, "car 2 down past the bottom");
+		ExpectReport(board, { Step(1, right, 1) }, carOnTopOfCar, 0, "car 1 onto car 3");
+		ExpectReport(board, { Step(3, down, 1), Step(1, right, 3) }, carOnTopOfCar, 1, "car 1 through to car 2");
+		ExpectReport(board, { Step(2, down, 2), Step(4, right, 3) }, carOnTopOfCar, 1, "car 4 through car 3");
+
+		// a failed move leaves the board as it was
+		SolutionValidator validator;
+		validator.Reset(board);
+		std::vector<unsigned> before = validator.Cells();
+		Expect(validator.Move(Step(1, right, 3)) == carOnTopOfCar && validator.Cells() == before, "validator: failed move changed the board");
+
+		ParkingLotBoard broken = board;
+		broken.cells[0] = 6;
+		ExpectReport(broken, { Step(2, down, 2) }, badBoard, 0, "car of one cell");
+		broken = board;
+		broken.car = 8;
+		ExpectReport(broken, MoveList(), badBoard, 0, "no main car");
+	}
+
+	// more pairs than ValidateBatch gives one thread, the solutions of the levels with
+	// moves dropped, turned around and lengthened
+	void BatchMatchesSequential()
+	{
+		std::vector<ParkingLotBoard> levels;
+		std::vector<MoveList> shortest;
+		for (char const * name : { "level.0", "level.1", "level.2", "level.3", "level.4", "level.5", "level.6", "level.free", "level.hard" }) {
+			RushHourSolver solver(name);
+			solver.InitCarLocations();
+			levels.push_back(solver.Board());
+			shortest.push_back(MoveList());
+			solver.SolveBreadthFirst(shortest.back());
+		}
+
+		size_t const pairs = 3 * 4096 + 17;
+		std::vector<ParkingLotBoard> boards;
+		std::vector<MoveList> solutions;
+		for (size_t i = 0; i < pairs; ++i) {
+			size_t level = i % levels.size();
+			MoveList moves = shortest[level];
+			size_t at = (i / levels.size()) % moves.size();
+			switch ((i / levels.size() / moves.size()) % 4) {
+			case 1: moves.erase(moves.begin() + static_cast<std::ptrdiff_t>(at)); break;
+			case 2: moves[at] = ReverseMove(moves[at]); break;
+			case 3: ++std::get<2>(moves[at]); break;
+			}
+			boards.push_back(levels[level]);
+			solutions.push_back(moves);
+		}
+
+		std::vector<ValidationReport> reports;
+		ValidateBatch(boards, solutions, reports, 4);
+		Expect(reports.size() == pairs, "batch: wrong number of reports");
+		SolutionValidator validator;
+		unsigned mismatches = 0;
+		unsigned kinds[badBoard + 1] = {};
+		for (size_t i = 0; i < pairs && i < reports.size(); ++i) {
+			ValidationReport report = validator.Validate(boards[i], solutions[i]);
+			if (report.result != reports[i].result || report.failedMove != reports[i].failedMove)
+				++mismatches;
+			++kinds[report.result];
+		}
+		Expect(mismatches == 0, "batch: " + std::to_string(mismatches) + " reports differ from Validate");
+		Expect(kinds[validSolution] && kinds[notSolved] && kinds[outOfParkingLot] && kinds[carOnTopOfCar], "batch: the pairs don't cover the results");
+	}
+
+	// a position without a solution is searched once, after that it is remembered
+	void SessionNoSolution()
+	{
+		RushHourSession session("level.locked", 16);
+		Expect(!session.Explored(), "session: level.locked explored with 16 states");
+		Expect(session.Distance() == RushHourSession::noSolution, "session: level.locked has a distance");
+		RushHourSession::Move move;
+		Expect(!session.Hint(move), "session: hint for level.locked");
+		Expect(session.Distance() == RushHourSession::noSolution, "session: level.locked has a distance the second time");
+		Expect(session.LocalSearches() == 1, "session: level.locked searched " + std::to_string(session.LocalSearches()) + " times");
+	}
+
+	// the states of an unsolvable board run out, the bound of IDA* doesn't: level.locked
+	// has 1420 states with cycles the bound keeps rising over
+	void GenericIDAUnsolvable(std::string const & level)
+	{
+		RushHourSolver solver(level);
+		solver.InitCarLocations();
+		SolveResult result = RunEngine(FindEngine("generic-ida"), solver, std::chrono::steady_clock::now() + std::chrono::seconds(60));
+		Expect(result.status == statusNoSolution, "generic-ida: " + level + " ended " + StatusName(result.status));
+	}
+
+	// level.hard has more states than the session keeps, so every hint comes from a local
+	// search whose solution is longer than the cache too
+	void SessionCache()
+	{
+		size_t const maxStates = 16;
+		RushHourSession session("level.hard", maxStates);
+		Expect(!session.Explored(), "session: level.hard explored with 16 states");
+		unsigned moves = 0;
+		size_t kept = 0;
+		RushHourSession::Move move;
+		while (!session.IsSolved() && moves < 49 && session.Hint(move)) {
+			kept = std::max(kept, session.States());
+			session.Play(move);
+			++moves;
+		}
+		Expect(kept <= maxStates, "session: more states kept than maxStates");
+		Expect(session.IsSolved() && moves == 49, "session: hints didn't solve level.hard in 49 moves");
+	}
+}
+
+int main()
+{
+	try {
+		UnsolvableThenSolvable("iterative deepening", &RushHourSolver::SolveIterativeDeepening);
+		UnsolvableThenSolvable("cheapest", &RushHourSolver::SolveCheapest);
+		ReplaySolution();
+		SessionCache();
+		SessionNoSolution();
+		IllegalMoves();
+		BatchMatchesSequential();
+		GenericIDAUnsolvable("level.stuck");
+		GenericIDAUnsolvable("level.locked");
+	}
+	catch (char const * message) {
+		std::cout << "FAILED " << message << '\n';
+		++failures;
+	}
+	std::cout << (failures ? "some tests failed\n" : "all tests passed\n");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,97 @@
+/*!
+* \file rhtrace.cpp
+* \author Egemen Koku
+* \date 19 Oct 2026
+* \brief Records solutions or whole searches as traces and decodes binary traces
+*        into the text format used by Prof. Mead's Game Board Server. Also times the
+*        phases of a batch of levels as a Chrome trace.
+*
+* \copyright Digipen Institute of Technology
+*
+*/
+
+#include "rushhour.h"
+#include "trace.h"
+#include "phases.h"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <chrono>
+
+int main(int argc, char ** argv)
+{
+	std::string command = argc > 1 ? argv[1] : "";
+
+	if (command == "decode" && argc == 3) {
+		std::ifstream in(argv[2], std::ios::binary);
+		if (!DecodeTrace(in, std::cout)) {
+			std::cerr << "not a binary trace: " << argv[2] << std::endl;
+			return 1;
+		}
+		return 0;
+	}
+
+	if (command == "phases" && argc >= 5) {
+		bool optimal = std::string(argv[2]) != "0";
+		std::ofstream out(argv[3]);
+		PhaseTimeline timeline;
+		SolveOptions options;
+		options.timeline = &timeline;
+
+		try {
+			// every level like the driver runs it: solve, then check the solution
+			for (int level = 4; level < argc; ++level) {
+				std::cout << argv[level] << '\n';
+				MoveList sol = optimal ? SolveRushHourOptimally(argv[level], options) : SolveRushHour(argv[level], options);
+				// the solve recorded the parse of the level already, only the check is timed
+				RushHourSolver checker(argv[level]);
+				checker.Timeline(&timeline);
+				checker.CheckBrief(sol);
+			}
+		}
+		catch (char const * msg) {
+			std::cerr << " in rhtrace " << msg << std::endl;
+			return 1;
+		}
+		timeline.WriteChromeTrace(out);
+		timeline.WriteSummary(std::cout);
+		return 0;
+	}
+
+	if ((command == "search" || command == "solution") && (argc == 5 || argc == 6)) {
+		std::string filename(argv[2]);
+		bool optimal = std::string(argv[3]) != "0";
+		TraceMode mode = (argc == 6 && std::string(argv[5]) == "text") ? textTrace : binaryTrace;
+		std::ofstream out(argv[4], std::ios::binary);
+
+		try {
+			TraceWriter trace(out, mode);
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			MoveList sol;
+			if (command == "search") {
+				sol = optimal ? SolveRushHourOptimally(filename, trace) : SolveRushHour(filename, trace);
+			}
+			else {
+				sol = optimal ? SolveRushHourOptimally(filename) : SolveRushHour(filename);
+				trace.Start(RushHourSolver(filename).Board());
+				trace.Solution(sol);
+				trace.Flush();
+			}
+			std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+			std::cout << "Number of steps = " << sol.size() << '\n';
+			std::cout << "Recorded moves = " << trace.Records() << '\n';
+			std::cout << "Time elapsed " << elapsed.count() << '\n';
+		}
+		catch (char const * msg) {
+			std::cerr << " in rhtrace " << msg << std::endl;
+			return 1;
+		}
+		return 0;
+	}
+
+	std::cout << "Usage ./" << argv[0] << " search <level> <optimal=1, any=0> <output> <optional text|binary (default)>\n"
+	          << "      ./" << argv[0] << " solution <level> <optimal=1, any=0> <output> <optional text|binary (default)>\n"
+	          << "      ./" << argv[0] << " decode <binary trace>\n"
+	          << "      ./" << argv[0] << " phases <optimal=1, any=0> <output json> <level> <more levels>\n";
+	return 1;
+}
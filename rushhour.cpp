@@ -11,29 +11,104 @@
 
 #include <iostream>
 #include "rushhour.h"
+#include "validator.h"
+#include "trace.h"
+#include "phases.h"
 #include <string>
+#include <random>
+#include <queue>
+#include <algorithm>
+#include <cmath>
 
-#define LOG_ENABLED 0
-#define CLOSED_LIST_OPT 1
+// closed list, partial order, move ordering, tracing, logging, the hash check and the
+// visited set are picked at run time, see SearchPolicy
 
-#if LOG_ENABLED
+template<bool Enabled>
 void LOG() {
-	std::cout << std::endl;
+	if (Enabled)
+		std::cout << std::endl;
 }
 
+// Helper function for printing lines and debugging (because boy is it necessary), prints
+// nothing unless Enabled (the logging of SearchPolicy)
+template<bool Enabled, typename Word, typename ...Rest>
+void LOG(Word && word, Rest && ...rest) {
+	if (Enabled)
+		std::cout << word << ' ';
+	LOG<Enabled>(std::forward<Rest>(rest)...);
+}
 
-#else
-void LOG() {
+std::tuple<unsigned, Direction, unsigned> ReverseMove(std::tuple<unsigned, Direction, unsigned> const & move) {
+	return std::tuple<unsigned, Direction, unsigned>(std::get<0>(move), static_cast<Direction>((std::get<1>(move) + 2) % 4), std::get<2>(move));
 }
 
-// Helper function for printing lines and debugging (because boy is it necessary)
-template<typename Word, typename ...Rest>
-void LOG(Word && word, Rest && ...rest) {
-	static_cast<void>(word); // for getting rid of the unused param error
-	LOG(std::forward<Rest>(rest)...);
+// Bits a car position takes in a packed state (see PackState)
+unsigned PositionBits(unsigned height, unsigned width) {
+	unsigned bits = 1;
+	while ((1u << bits) < std::max(height, width))
+		++bits;
+	return bits;
+}
+
+// Position of a car along its line: its column if horizontal, its row if vertical
+unsigned & Position(CarInfo & info) {
+	return info.orientation == horisontal ? info.column : info.row;
+}
+
+// Packed state of RushHourSolver::ExploreComponent, only the positions of the cars
+void PackState(CarLocations const & locations, unsigned bits, std::uint64_t & packed) {
+	packed = 0;
+	for (size_t index = locations.size(); index-- > 0; ) {
+		CarInfo const & info = locations[index];
+		packed = packed << bits | (info.orientation == horisontal ? info.column : info.row);
+	}
+}
+
+void PackState(CarLocations const & locations, unsigned, std::string & packed) {
+	packed.resize(locations.size());
+	for (size_t index = 0; index < locations.size(); ++index) {
+		CarInfo const & info = locations[index];
+		packed[index] = static_cast<char>(info.orientation == horisontal ? info.column : info.row);
+	}
+}
+
+// Reverse of PackState, locations has to hold the same cars already
+void UnpackState(std::uint64_t packed, unsigned bits, CarLocations & locations) {
+	std::uint64_t mask = (static_cast<std::uint64_t>(1) << bits) - 1;
+	for (CarInfo & info : locations) {
+		Position(info) = static_cast<unsigned>(packed & mask);
+		packed >>= bits;
+	}
+}
+
+void UnpackState(std::string const & packed, unsigned, CarLocations & locations) {
+	for (size_t index = 0; index < locations.size(); ++index) {
+		Position(locations[index]) = static_cast<unsigned char>(packed[index]);
+	}
 }
-#endif
 
+// Memory estimates: bytes malloc adds to every block, and what a frame that lists its moves
+// allocates for its two move deques (a map of 8 pointers plus one 512 byte chunk each)
+size_t const allocationOverhead = 16;
+size_t const frameBytes = 2 * (sizeof(PossibleMoveVector) + 8 * sizeof(void*) + 512 + 2 * allocationOverhead);
+
+// nodes the recursion searches before it makes sure the board has a solution
+unsigned long long const componentCheckNodes = 1 << 16;
+
+// Estimated bytes of a node based hash map: the nodes, what their values own and the buckets
+template<typename StateMap>
+size_t HashMapBytes(StateMap const & states, size_t valueBytes) {
+	return states.size() * (sizeof(void*) + sizeof(typename StateMap::value_type) + allocationOverhead + valueBytes)
+		+ states.bucket_count() * sizeof(void*);
+}
+
+// Estimated bytes of paths that all have the same length (the frontier checkpoints)
+size_t PathsBytes(std::vector<MoveList> const & paths) {
+	if (paths.empty())
+		return paths.capacity() * sizeof(MoveList);
+	return paths.capacity() * sizeof(MoveList)
+		+ paths.size() * (paths.front().capacity() * sizeof(MoveList::value_type) + allocationOverhead);
+}
 
 // Keep this
 std::ostream& operator<<( std::ostream& os, Direction const& d ) {
@@ -52,9 +127,22 @@ MoveList SolveRushHour(std::string const & filename)
 	RushHourSolver rh(filename);
 	rh.InitCarLocations();
 	MoveList allMoves;
+	if(!rh.SolveBestFirst(allMoves)) {
+		std::cout << "Rush hour solution couldn't found" << std::endl;
+	}
+	return allMoves;
+}
+
+MoveList SolveRushHour(std::string const & filename, TraceWriter & trace)
+{
+	RushHourSolver rh(filename);
+	rh.InitCarLocations();
+	rh.Trace(&trace);
+	MoveList allMoves;
 	if(!rh.SolveRushHourRec(allMoves)) {
 		std::cout << "Rush hour solution couldn't found" << std::endl;
 	}
+	trace.Flush();
 	return allMoves;
 }
 
@@ -62,19 +150,63 @@ MoveList SolveRushHourOptimally ( std::string const& filename ) {
 
 	RushHourSolver rh(filename);
 	rh.InitCarLocations();
-	unsigned maxLevel = 1;
 	MoveList allMoves;
-	bool done = false;
-	// loop through until it's solved
-	// Warning: I'm not checking for a max level so it'll crash if the max depth is high
-	do {
-#if CLOSED_LIST_OPT
-		rh.ClearClosedList();
-#endif
-		rh.MaxIteration(++maxLevel);
-		done = rh.SolveRushHourRec(allMoves);
-	} while (!done);
+	rh.SolveIterativeDeepening(allMoves);
+	return allMoves;
+}
+
+MoveList SolveRushHourOptimally ( std::string const& filename, TraceWriter & trace ) {
+
+	RushHourSolver rh(filename);
+	rh.InitCarLocations();
+	rh.Trace(&trace);
+	MoveList allMoves;
+	rh.SolveIterativeDeepening(allMoves);
+	trace.Flush();
+	return allMoves;
+}
+
+MoveList SolveRushHour ( std::string const& filename, SolveOptions const & options ) {
+
+	PhaseScope level(options.timeline, "SolveRushHour", "level");
+	level.Arg("level", filename);
+	RushHourSolver rh(filename, options.timeline);
+	rh.InitCarLocations();
+	rh.Options(options);
+	MoveList allMoves;
+	if (options.filterStates) {
+		// best-first keeps every state for the path back, depth first only the path
+		rh.Filter(options.filterStates, options.falsePositiveRate);
+		rh.SolveRushHourRec(allMoves);
+	}
+	else {
+		rh.SolveBestFirst(allMoves);
+	}
+	return allMoves;
+}
+
+MoveList SolveRushHourOptimally ( std::string const& filename, SolveOptions const & options ) {
+
+	PhaseScope level(options.timeline, "SolveRushHourOptimally", "level");
+	level.Arg("level", filename);
+	RushHourSolver rh(filename, options.timeline);
+	rh.InitCarLocations();
+	rh.Options(options);
+	MoveList allMoves;
+	rh.SolveIterativeDeepening(allMoves);
+	return allMoves;
+}
+
+MoveList SolveRushHourCheapest ( std::string const& filename, MoveCost const & cost, SolveOptions const & options ) {
 
+	PhaseScope level(options.timeline, "SolveRushHourCheapest", "level");
+	level.Arg("level", filename);
+	RushHourSolver rh(filename, options.timeline);
+	rh.InitCarLocations();
+	rh.Options(options);
+	rh.Cost(cost);
+	MoveList allMoves;
+	rh.SolveCheapest(allMoves);
 	return allMoves;
 }
 
@@ -95,8 +227,10 @@ void CarInfo::PrintCarInfo ( unsigned carID ) const {
 }
 
 // ParkingLot implementation
-RushHourSolver::RushHourSolver(std::string const&  filename) : filename(filename)
+RushHourSolver::RushHourSolver(std::string const&  filename, PhaseTimeline * timeline) : filename(filename), timeline(timeline)
 {
+	PhaseScope parse(timeline, "parse");
+	parse.Arg("level", filename);
 	std::ifstream infile(filename);
 	std::string   data; // all data from input file
 
@@ -116,42 +250,52 @@ RushHourSolver::RushHourSolver(std::string const&  filename) : filename(filename
 	infile.close();
 
 	// parse data
+	// compiled once, the daemon constructs a solver per new level
+	static std::regex const reWidth(".*width\\s+(\\d+).*", std::regex_constants::icase);
+	static std::regex const reWidthKey("width\\s+\\d+", std::regex_constants::icase);
+	static std::regex const reHeight(".*height\\s+(\\d+).*", std::regex_constants::icase);
+	static std::regex const reHeightKey("height\\s+\\d+", std::regex_constants::icase);
+	static std::regex const reCar(".*car\\s+(\\d+).*", std::regex_constants::icase);
+	static std::regex const reCarKey("car\\s+\\d+", std::regex_constants::icase);
+	static std::regex const reExit(".*exit\\s+([a-z]+).*", std::regex_constants::icase);
+	static std::regex const reExitKey("exit\\s+[a-z]+", std::regex_constants::icase);
+	static std::regex const re_cell("(\\d+)"); // each cell is a number or dot
 	std::smatch match;
 
-	if (std::regex_match(data, match, std::regex(".*width\\s+(\\d+).*", std::regex_constants::icase)) && match.size() == 2) {
+	if (std::regex_match(data, match, reWidth) && match.size() == 2) {
 		// The first sub_match is the whole string; the next
 		// sub_match is the first parenthesized expression.
 		width = std::stoi(match[1]);
-		data = std::regex_replace(data, std::regex("width\\s+\\d+", std::regex_constants::icase), "");
+		data = std::regex_replace(data, reWidthKey, "");
 	}
 	else {
 		std::cerr << "Errors in input file: cannot find \"width\"" << std::endl;
 		throw "Errors in input file: cannot find \"width\"";
 	}
-	if (std::regex_match(data, match, std::regex(".*height\\s+(\\d+).*", std::regex_constants::icase)) && match.size() == 2) {
+	if (std::regex_match(data, match, reHeight) && match.size() == 2) {
 		height = std::stoi(match[1]);
-		data = std::regex_replace(data, std::regex("height\\s+\\d+", std::regex_constants::icase), "");
+		data = std::regex_replace(data, reHeightKey, "");
 	}
 	else {
 		std::cerr << "Errors in input file: cannot find \"height\"" << std::endl;
 		throw "Errors in input file: cannot find \"height\"";
 	}
-	if (std::regex_match(data, match, std::regex(".*car\\s+(\\d+).*", std::regex_constants::icase)) && match.size() == 2) {
+	if (std::regex_match(data, match, reCar) && match.size() == 2) {
 		car = std::stoi(match[1]);
-		data = std::regex_replace(data, std::regex("car\\s+\\d+", std::regex_constants::icase), "");
+		data = std::regex_replace(data, reCarKey, "");
 	}
 	else {
 		std::cerr << "Errors in input file: cannot find \"car\"" << std::endl;
 		throw "Errors in input file: cannot find \"car\"";
 	}
-	if (std::regex_match(data, match, std::regex(".*exit\\s+([a-z]+).*", std::regex_constants::icase)) && match.size() == 2) {
+	if (std::regex_match(data, match, reExit) && match.size() == 2) {
 		std::string dir_str = match[1].str();
 		if (dir_str == "left") { exitDirection = left; }
 		else if (dir_str == "right") { exitDirection = right; }
 		else if (dir_str == "up") { exitDirection = up; }
 		else if (dir_str == "down") { exitDirection = down; }
 		else { throw "unknown exit direction "; }
-		data = std::regex_replace(data, std::regex("exit\\s+[a-z]+", std::regex_constants::icase), "");
+		data = std::regex_replace(data, reExitKey, "");
 	}
 	else {
 		std::cerr << "Errors in input file: cannot find \"exit\"" << std::endl;
@@ -159,7 +303,6 @@ RushHourSolver::RushHourSolver(std::string const&  filename) : filename(filename
 	}
 
 	// only cells are left in the data
-	std::regex re_cell("(\\d+)"); // each cell is a number or dot
 	std::sregex_iterator cell_matches_begin = std::sregex_iterator(data.begin(), data.end(), re_cell);
 	std::sregex_iterator cell_matches_end = std::sregex_iterator();
 
@@ -179,6 +322,7 @@ RushHourSolver::RushHourSolver(std::string const&  filename) : filename(filename
 		throw "Errors in input file: number of cells";
 	}
 
+	IndexCars();
 }
 
 // Direction is an enum (see header):
@@ -197,7 +341,7 @@ RushHourSolver::RushHourSolver(std::string const&  filename) : filename(filename
 //
 
 //                                move = car,    direction, num positions
-void RushHourSolver::makeMove(std::tuple< unsigned, Direction, unsigned > move)
+void RushHourSolver::MoveCar(std::tuple< unsigned, Direction, unsigned > move)
 {
 	int d = std::get<1>(move); // convert direction to int
 	int deltaRow = (d - 1)*((3 - d) % 2);    // see comment before function
@@ -205,184 +349,1091 @@ void RushHourSolver::makeMove(std::tuple< unsigned, Direction, unsigned > move)
 	int scan_direction = deltaRow + deltaColumn; // -1 (up,left) or 1 (down,right)
 
 	unsigned num_positions = std::get<2>(move);
-	unsigned car = std::get<0>(move);
+	unsigned index = std::get<0>(move);
 
+	// the car index is the index into the car locations
+	size_t cells = static_cast<size_t>(height) * width;
+	CarInfo & carInfo = currentCarLocations[index];
 
+	// Get the starting and ending positions
+	unsigned row_start = (deltaRow != 0 && scan_direction == 1) ? carInfo.row + carInfo.size - 1 : carInfo.row;
+	unsigned column_start = (deltaColumn != 0 && scan_direction == 1) ? carInfo.column + carInfo.size - 1 : carInfo.column;
+	unsigned row_end = row_start + deltaRow * num_positions;
+	unsigned column_end = column_start + deltaColumn * num_positions;
 
-	// I changed this function. Since I'm storing car info, the moment I find the car ID
-	// I can just move numbers based on the size and the orientation information of the car
-	for(auto & pair:currentCarLocations) {
-		if(pair.first == car) {
-			CarInfo const & carInfo = pair.second;
+	for (unsigned counter = 0; counter < carInfo.size; ++counter) {
 
-			// Get the starting and ending positions
-			unsigned row_start = (deltaRow != 0 && scan_direction == 1) ? carInfo.row + carInfo.size - 1 : carInfo.row;
-			unsigned column_start = (deltaColumn != 0 && scan_direction == 1) ? carInfo.column + carInfo.size - 1 : carInfo.column;
-			unsigned row_end = row_start + deltaRow * num_positions;
-			unsigned column_end = column_start + deltaColumn * num_positions;
+		// swapping part 1
+		parkingLot[row_start][column_start] = noCar;
 
-			for (unsigned counter = 0; counter < carInfo.size; ++counter) {
+		// check if legal
+		if (row_end >= height && column_end >= width) {
+			throw("Car moved outside of parking lot");
+		}
+		if (parkingLot[row_end][column_end] != noCar) {
+			throw("Car moved on top of another car");
+		}
 
-				// swapping part 1
-				parkingLot[row_start][column_start] = 0;
+		// swapping part 2
+		parkingLot[row_end][column_end] = index;
 
-				// check if legal
-				if (row_end >= height && column_end >= width) {
-					throw("Car moved outside of parking lot");
-				}
-				if (parkingLot[row_end][column_end] > 0) {
-					throw("Car moved on top of another car");
-				}
+		// advance "pointers"
+		row_start += -deltaRow;
+		column_start += -deltaColumn;
+		row_end += -deltaRow;
+		column_end += -deltaColumn;
 
-				// swapping part 2
-				parkingLot[row_end][column_end] = car;
+	}
 
-				// advance "pointers"
-				row_start += -deltaRow;
-				column_start += -deltaColumn;
-				row_end += -deltaRow;
-				column_end += -deltaColumn;
+	// Also update car info and swap the car's key in the hash
+	stateHash ^= zobristKeys[index * cells + carInfo.row * width + carInfo.column];
+	carInfo.row += deltaRow * num_positions;
+	carInfo.column += deltaColumn * num_positions;
+	stateHash ^= zobristKeys[index * cells + carInfo.row * width + carInfo.column];
 
-			}
-			
-			// Also update car info
-			pair.second.row = carInfo.row + deltaRow * num_positions;
-			pair.second.column = carInfo.column + deltaColumn * num_positions;
-		}
-	}
-	
 }
 
-bool RushHourSolver::IsSolved() const
+// the car number of the file to its index, unknown cars are left alone as before
+void RushHourSolver::makeMove(std::tuple< unsigned, Direction, unsigned > move)
 {
-	unsigned i_car_pos = height;
-	unsigned j_car_pos = width;
-	Orientation orientation = horisontal;
-	bool done = false;
-	for (unsigned i = 0; i<height && !done; ++i) {
-		for (unsigned j = 0; j<width && !done; ++j) {
-			if (parkingLot[i][j] == car) {
-				if (i_car_pos == height) { // first time seeing car
-					i_car_pos = i;
-					j_car_pos = j;
-				}
-				else { //second time - ready to make decision 
-					if (j_car_pos == j) { // default is horisontal
-						orientation = vertical;
-					}
-					done = true;
-				}
-			}
+	std::vector<unsigned>::const_iterator id = std::find(carIds.begin(), carIds.end(), std::get<0>(move));
+	if (id == carIds.end())
+		return;
+	std::get<0>(move) = static_cast<unsigned>(id - carIds.begin());
+	MoveCar(move);
+}
+
+ParkingLotBoard RushHourSolver::Board() const
+{
+	ParkingLotBoard board;
+	board.height = height;
+	board.width = width;
+	board.car = car;
+	board.exitDirection = exitDirection;
+	board.cells.reserve(height * width);
+	for (std::vector<unsigned> const & row : parkingLot) {
+		for (unsigned cell : row) {
+			board.cells.push_back(cell == noCar ? 0 : carIds[cell]);
 		}
 	}
+	return board;
+}
 
-	bool solved = false;
+bool RushHourSolver::IsSolved() const
+{
+	// the main car is index 0
+	CarInfo const & info = currentCarLocations[0];
 	switch (exitDirection) {
-	case up:    solved = orientation == vertical   && parkingLot[0][j_car_pos] == car; break;
-	case left:  solved = orientation == horisontal && parkingLot[i_car_pos][0] == car; break;
-	case down:  solved = orientation == vertical   && parkingLot[height - 1][j_car_pos] == car; break;
-	case right: solved = orientation == horisontal && parkingLot[i_car_pos][width - 1] == car; break;
-	default: break;
+	case up:    return info.orientation == vertical   && info.row == 0;
+	case left:  return info.orientation == horisontal && info.column == 0;
+	case down:  return info.orientation == vertical   && info.row + info.size == height;
+	case right: return info.orientation == horisontal && info.column + info.size == width;
+	default:    return false;
 	}
-	return solved;
 }
 
 int RushHourSolver::Check(std::vector< std::tuple<unsigned, Direction, unsigned> > const& sol)
 {
-	try {
-		for (std::tuple<unsigned, Direction, unsigned> const& m : sol) {
-			std::cout << "Car " << std::get<0>(m) << " to be moved " << std::get<1>(m) << " " << std::get<2>(m) << " positions\n";
-			makeMove(m);
+	PhaseScope check(timeline, "check");
+	SolutionValidator validator;
+	ValidationResult result = validator.Reset(Board());
+	for (std::tuple<unsigned, Direction, unsigned> const& m : sol) {
+		if (result != validSolution) {
+			break;
 		}
-		bool final_pos = IsSolved();
-		std::cout << "Number of steps = " << sol.size() << std::endl;
-		std::cout << "Solved = " << final_pos << std::endl;
-		return final_pos;
+		std::cout << "Car " << std::get<0>(m) << " to be moved " << std::get<1>(m) << " " << std::get<2>(m) << " positions\n";
+		result = validator.Move(m);
 	}
-	catch (char const * msg) {
-		std::cout << "ERROR - " << msg << std::endl;
+	if (result != validSolution) {
+		std::cout << "ERROR - " << ValidationMessage(result) << '\n';
 		return 1;
 	}
+	bool final_pos = validator.IsSolved();
+	std::cout << "Number of steps = " << sol.size() << '\n';
+	std::cout << "Solved = " << final_pos << '\n';
+	return final_pos;
 }
 
 int RushHourSolver::CheckBrief(std::vector< std::tuple<unsigned, Direction, unsigned> > const& sol)
 {
-	std::cout << "Number of steps = " << sol.size() << std::endl;
-	try {
-		for (std::tuple<unsigned, Direction, unsigned> const& m : sol) {
-			makeMove(m);
-		}
-		bool final_pos = IsSolved();
-		std::cout << "Solved = " << final_pos << std::endl;
-		return final_pos;
-	}
-	catch (char const * msg) {
-		std::cout << "ERROR - " << msg << std::endl;
+	PhaseScope check(timeline, "check");
+	std::cout << "Number of steps = " << sol.size() << '\n';
+	SolutionValidator validator;
+	ValidationReport report = validator.Validate(Board(), sol);
+	if (report.result != validSolution && report.result != notSolved) {
+		std::cout << "ERROR - " << ValidationMessage(report.result) << '\n';
 		return 1;
 	}
+	bool final_pos = report.result == validSolution;
+	std::cout << "Solved = " << final_pos << '\n';
+	return final_pos;
 }
 
 bool RushHourSolver::SolveRushHourRec ( MoveList & solution )
 {
+	PhaseScope phase(timeline, "depth first", "search");
+	BeginSolve();
+	bool solved = (this->*SelectSearch(true))(solution);
+	{
+		PhaseScope path(timeline, "path");
+		ToCarIds(solution);
+	}
+	phase.Arg("nodes", nodes);
+	phase.Arg("moves", solution.size());
+	// the component check explored from the root, its goal depth is the length of a shortest solution
+	if (componentExplored && component.solvable)
+		phase.Arg("shortest", component.goalDepth);
+	return solved;
+}
+
+// bits of the table of SelectSearch, one per switch of SearchPolicy
+unsigned const tracingBit = 1;
+unsigned const blockerOrderBit = 2;
+unsigned const partialOrderBit = 4;
+unsigned const closedListBit = 8;
+unsigned const loggingBit = 16;
+unsigned const hashCheckBit = 32;
+unsigned const filterBit = 64;
+unsigned const searchKinds = 128;
+
+// Policy of a combination of the bits. The filter goes without the closed list and the
+// ordering, so their bits are dropped with it and the table repeats the same search.
+template<unsigned Bits, bool Filtered = (Bits & filterBit) != 0>
+struct PolicyOf {
+	typedef SearchPolicy<!Filtered && (Bits & closedListBit) != 0, (Bits & partialOrderBit) != 0,
+	                     !Filtered && (Bits & blockerOrderBit) != 0 ? blockerOrder : naturalOrder,
+	                     (Bits & tracingBit) != 0, (Bits & loggingBit) != 0, (Bits & hashCheckBit) != 0,
+	                     Filtered ? filterVisited : exactVisited> Policy;
+};
+
+RushHourSolver::SearchFunction RushHourSolver::SelectSearch ( bool filtered ) const
+{
+	// filled the first time a search is picked, the initialization is thread safe
+	static SearchFunction searches[searchKinds];
+	static bool const filled = (FillSearches<searchKinds - 1>(searches, std::true_type()), true);
+	static_cast<void>(filled);
+
+	unsigned bits = (trace ? tracingBit : 0) | (moveOrdering == blockerOrder ? blockerOrderBit : 0)
+		| (partialOrderOpt ? partialOrderBit : 0) | (closedListOpt ? closedListBit : 0)
+		| (logging ? loggingBit : 0) | (hashCheck ? hashCheckBit : 0)
+		| (filtered && filter.Enabled() ? filterBit : 0);
+	return searches[bits];
+}
+
+template<unsigned Bits>
+void RushHourSolver::FillSearches ( SearchFunction * searches, std::true_type )
+{
+	typedef typename PolicyOf<Bits>::Policy Policy;
+	searches[Bits] = SearchOf<Policy>(std::integral_constant<VisitedSet, Policy::visited>());
+	FillSearches<Bits - 1>(searches, std::integral_constant<bool, (Bits > 0)>());
+}
+
+template<typename Policy>
+RushHourSolver::SearchFunction RushHourSolver::SearchOf ( std::integral_constant<VisitedSet, exactVisited> )
+{
+	return &RushHourSolver::Search<Policy>;
+}
+
+template<typename Policy>
+RushHourSolver::SearchFunction RushHourSolver::SearchOf ( std::integral_constant<VisitedSet, filterVisited> )
+{
+	return &RushHourSolver::SearchFiltered<Policy>;
+}
+
+template<typename Policy>
+bool RushHourSolver::Search ( MoveList & solution )
+{
+	// the clock is only read every few thousand nodes
+	if ((++nodes & 4095) == 0) {
+		AccountRecursion(solution);
+		CheckLimits(currentLevel - 1, closedList.Size());
+		// Depth first searches a board without a solution for as long as there are new
+		// paths, so past a few thousand nodes the component is explored to rule that out.
+		// Any state of it would do, every move can be taken back, but from the root the goal
+		// depth is the length of a shortest solution.
+		if (!componentExplored && nodes - solveNodes >= componentCheckNodes && !stopped) {
+			componentExplored = true;
+			CarLocations current = currentCarLocations;
+			PlaceState(solveRoot);
+			ExploreComponent();
+			PlaceState(current);
+		}
+	}
+	if (stopped)
+		return false;
+
 	// for IDA - return
 	if (currentLevel > maxIterationLevel)
 		return false;
 
+	LOG<Policy::logging>("depth", currentLevel - 1, "hash", stateHash);
+	if (Policy::logging)
+		PrintMap();
+
 
 	if(IsSolved())
 		return true;
 
-#if CLOSED_LIST_OPT
-	ClosedList::iterator iter = std::find(closedList.begin(), closedList.end(), currentCarLocations);
-	if (iter != closedList.end()) {
-		if(solution.size() < iter->solSize) {
-			iter->solSize = solution.size();
-			closedList.erase(iter);
+	// moves this node may still make in the current iteration
+	unsigned remaining = maxIterationLevel - currentLevel;
+
+	if (Policy::closedList) {
+		// a deeper bound than the one it failed with searches it again, the entry is raised after
+		size_t known = closedList.Find(stateHash, Key());
+		if (known != StateTable::noState && remaining <= closedList.Value(known))
+			return false;
+	}
+
+	// children would be cut off right away, next iteration starts here
+	if (remaining == 0) {
+		if (recordFrontier) {
+			if (frontier.size() < frontierLimit)
+				frontier.push_back(solution);
+			else
+				recordFrontier = false;
 		}
-		else { return false; }
+		if (Policy::closedList && closedListEnabled)
+			closedList.Set(stateHash, Key(), remaining);
+		return false;
 	}
-#endif
 
-	PossibleMoveVector possibleMoves;
-	ReverseMoveVector reverseMoves;
+	// the move generation leaves out what the previous move makes redundant
+	std::tuple<unsigned, Direction, unsigned> const * previous = Policy::partialOrder && !solution.empty() ? &solution.back() : nullptr;
+	if (Policy::ordering == blockerOrder) {
+		// every move has to be scored before the first one is tried
+		PossibleMoveVector possibleMoves;
+		ReverseMoveVector reverseMoves;
+		CalculatePossibleMoves(possibleMoves, reverseMoves, previous);
+		OrderMoves(possibleMoves, reverseMoves);
+
+		while(!possibleMoves.empty() && !stopped) {
+			std::tuple<unsigned, Direction, unsigned> move = possibleMoves.back();
+			possibleMoves.pop_back();
+			if (TryMove<Policy>(move, solution))
+				return true;
+		}
+	}
+	else {
+		// moves are generated one at a time, a node that is solved by its first
+		// child never looks at the cells of the others
+		MoveCursor cursor;
+		StartMoves(cursor, previous);
+		std::tuple<unsigned, Direction, unsigned> move;
+		while (!stopped && NextMove(cursor, move)) {
+			if (TryMove<Policy>(move, solution))
+				return true;
+		}
+	}
+	// only fully explored states go to the closed list
+	if (Policy::closedList && !stopped && closedListEnabled)
+		closedList.Set(stateHash, Key(), remaining);
+	return false;
+}
 
-	CalculatePossibleMoves(possibleMoves, reverseMoves);
+template<typename Policy>
+bool RushHourSolver::SearchFiltered ( MoveList & solution )
+{
+	// every state goes through the filter once, so the path can get as long as the component
+	// is large: the frames are on the heap and the path states are only in the filter
+	std::vector<MoveCursor> frames(1);
+	filter.Insert(stateHash);
+	bool solved = IsSolved();
+	if (!solved)
+		StartMoves(frames.back(), nullptr);
+
+	std::tuple<unsigned, Direction, unsigned> move;
+	while (!solved && !frames.empty() && !stopped) {
+		if ((++nodes & 4095) == 0) {
+			AccountFilter(frames.capacity(), solution);
+			CheckLimits(static_cast<unsigned>(solution.size()), filter.States());
+		}
+		if (NextMove(frames.back(), move)) {
+			MoveCar(move);
+			LOG<Policy::logging>("move", carIds[std::get<0>(move)], std::get<1>(move), std::get<2>(move));
+			if (Policy::tracing) {
+				trace->Move(CarIdMove(move));
+			}
+			if (Policy::hashCheck)
+				CheckHash();
+			if (filter.Insert(stateHash)) {
+				solution.push_back(move);
+				solved = IsSolved();
+				LOG<Policy::logging>("depth", solution.size(), "hash", stateHash);
+				if (Policy::logging)
+					PrintMap();
+				frames.emplace_back();
+				StartMoves(frames.back(), Policy::partialOrder ? &solution.back() : nullptr);
+				continue;
+			}
+		}
+		else {
+			frames.pop_back();
+			if (solution.empty())
+				break;
+			move = solution.back();
+			solution.pop_back();
+		}
+		std::tuple<unsigned, Direction, unsigned> reverseMove = ReverseMove(move);
+		MoveCar(reverseMove);
+		if (Policy::tracing) {
+			trace->Move(CarIdMove(reverseMove));
+		}
+		if (Policy::hashCheck)
+			CheckHash();
+	}
 
-	while(!possibleMoves.empty()) {
+	// stopped, back to the root like the recursion
+	if (!solved) {
+		while (!solution.empty()) {
+			MoveCar(ReverseMove(solution.back()));
+			solution.pop_back();
+		}
+	}
+	AccountFilter(frames.capacity(), solution);
+	return solved;
+}
 
-		std::tuple<unsigned, Direction, unsigned> move = possibleMoves.back();
-		possibleMoves.pop_back();
-		makeMove(move);
+template<typename Policy>
+bool RushHourSolver::TryMove ( std::tuple<unsigned, Direction, unsigned> const & move, MoveList & solution )
+{
+	MoveCar(move);
+	LOG<Policy::logging>("move", carIds[std::get<0>(move)], std::get<1>(move), std::get<2>(move));
+	if (Policy::tracing) {
+		trace->Move(CarIdMove(move));
+	}
+	if (Policy::hashCheck)
+		CheckHash();
 
-		// never seen this state
-		if(std::find(stateHistory.begin(), stateHistory.end(), currentCarLocations) == stateHistory.end()) {
+	// never seen this state
+	if(stateHistory.Find(stateHash, Key()) == StateTable::noState) {
 
-			stateHistory.push_back(currentCarLocations);
-			solution.push_back(move);
-			++currentLevel;
-			if (SolveRushHourRec(solution))
-				return true;
+		stateHistory.Insert(stateHash, key.data());
+		solution.push_back(move);
+		++currentLevel;
+		if (Search<Policy>(solution))
+			return true;
 
-			--currentLevel;
-			solution.pop_back();
-			stateHistory.pop_back();
+		--currentLevel;
+		solution.pop_back();
+		stateHistory.Erase(stateHash, Key());
+	}
+
+	std::tuple<unsigned, Direction, unsigned> reverseMove = ReverseMove(move);
+	MoveCar(reverseMove);
+	if (Policy::tracing) {
+		trace->Move(CarIdMove(reverseMove));
+	}
+	if (Policy::hashCheck)
+		CheckHash();
+	return false;
+}
+
+void RushHourSolver::CheckHash ( ) const
+{
+	if (stateHash != ComputeStateHash())
+		throw("Hash of the state went wrong after a move");
+}
+
+void RushHourSolver::OrderMoves ( PossibleMoveVector & possibleMoves, ReverseMoveVector & reverseMoves )
+{
+	// score every move by trying it, moves are taken from the back so the best goes last
+	std::vector<std::pair<unsigned, size_t>> scores;
+	scores.reserve(possibleMoves.size());
+	for (size_t i = 0; i < possibleMoves.size(); ++i) {
+		MoveCar(possibleMoves[i]);
+		scores.push_back(std::make_pair(BlockerScore(), i));
+		MoveCar(reverseMoves[i]);
+	}
+	// stable, so equal scores keep the natural order
+	std::stable_sort(scores.begin(), scores.end(), [](std::pair<unsigned, size_t> const & a, std::pair<unsigned, size_t> const & b) {
+		return a.first > b.first;
+	});
+
+	PossibleMoveVector orderedMoves;
+	ReverseMoveVector orderedReverses;
+	for (std::pair<unsigned, size_t> const & score : scores) {
+		orderedMoves.push_back(possibleMoves[score.second]);
+		orderedReverses.push_back(reverseMoves[score.second]);
+	}
+	possibleMoves.swap(orderedMoves);
+	reverseMoves.swap(orderedReverses);
+}
+
+unsigned RushHourSolver::BlockerScore ( ) const
+{
+	CarInfo const & info = currentCarLocations[0];
+	int deltaRow = 0;
+	int deltaColumn = 0;
+	unsigned row = info.row;
+	unsigned column = info.column;
+	switch (exitDirection) {
+	case up:    deltaRow = -1; break;
+	case left:  deltaColumn = -1; break;
+	case down:  deltaRow = 1; row += info.size - 1; break;
+	case right: deltaColumn = 1; column += info.size - 1; break;
+	default: return 0;
+	}
+
+	// walk from the front of the car to the exit
+	unsigned score = 0;
+	unsigned lastBlocker = noCar;
+	for (;;) {
+		row += deltaRow;
+		column += deltaColumn;
+		if (row >= height || column >= width)
+			break;
+		unsigned cell = parkingLot[row][column];
+		if (cell != noCar && cell != lastBlocker)
+			score += 2;
+		lastBlocker = cell;
+		++score;
+	}
+	return score;
+}
+
+unsigned RushHourSolver::LowerBound ( ) const
+{
+	if (IsSolved())
+		return 0;
+	CarInfo const & info = currentCarLocations[0];
+	int deltaRow = 0;
+	int deltaColumn = 0;
+	unsigned row = info.row;
+	unsigned column = info.column;
+	switch (exitDirection) {
+	case up:    deltaRow = -1; break;
+	case left:  deltaColumn = -1; break;
+	case down:  deltaRow = 1; row += info.size - 1; break;
+	case right: deltaColumn = 1; column += info.size - 1; break;
+	default: return 0;
+	}
+
+	// every car in the way moves at least once, then the main car does
+	unsigned bound = 1;
+	unsigned lastBlocker = noCar;
+	for (;;) {
+		row += deltaRow;
+		column += deltaColumn;
+		if (row >= height || column >= width)
+			break;
+		unsigned cell = parkingLot[row][column];
+		if (cell != noCar && cell != lastBlocker)
+			++bound;
+		lastBlocker = cell;
+	}
+	return bound;
+}
+
+void RushHourDomain::Moves ( std::vector<Move> & moves )
+{
+	solver.ListMoves(moves, partialOrder && !applied.empty() ? &applied.back() : nullptr);
+}
+
+void RushHourDomain::Undo ( Move const & move )
+{
+	solver.MoveCar(ReverseMove(move));
+	applied.pop_back();
+}
+
+void RushHourSolver::LoadState ( CarLocations const & locations )
+{
+	PlaceState(locations);
+	ForgetComponent();
+}
+
+void RushHourSolver::PlaceState ( CarLocations const & locations )
+{
+	for (std::vector<unsigned> & row : parkingLot) {
+		std::fill(row.begin(), row.end(), noCar);
+	}
+	for (unsigned index = 0; index < locations.size(); ++index) {
+		CarInfo const & info = locations[index];
+		for (unsigned k = 0; k < info.size; ++k) {
+			if (info.orientation == horisontal)
+				parkingLot[info.row][info.column + k] = index;
+			else
+				parkingLot[info.row + k][info.column] = index;
+		}
+	}
+	currentCarLocations = locations;
+	stateHash = ComputeStateHash();
+}
+
+void RushHourSolver::ForgetComponent ( )
+{
+	if (unsolvable)
+		stopped = cancelled;
+	unsolvable = false;
+	componentExplored = false;
+	component = ComponentReport();
+}
+
+void RushHourSolver::BeginSolve ( )
+{
+	ForgetComponent();
+	solveNodes = nodes;
+	solveRoot = currentCarLocations;
+}
+
+void RushHourSolver::CheckLimits ( unsigned depth, size_t closedListSize )
+{
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (now >= deadline)
+		stopped = true;
+	if (cancelToken.IsCancelled())
+		stopped = cancelled = true;
+
+	if (progress && now - lastProgress >= progressInterval) {
+		SearchProgress report;
+		report.depth = depth;
+		report.iteration = maxIterationLevel == std::numeric_limits<unsigned>::max() ? 0 : maxIterationLevel;
+		report.nodes = nodes;
+		report.nodesPerSecond = static_cast<double>(nodes - lastProgressNodes) / std::chrono::duration<double>(now - lastProgress).count();
+		report.closedListSize = closedListSize;
+		report.seconds = std::chrono::duration<double>(now - searchStart).count();
+		report.memoryBytes = memory.total.current;
+		lastProgress = now;
+		lastProgressNodes = nodes;
+		progress(report);
+	}
+}
+
+void RushHourSolver::Progress ( ProgressCallback const & callback, std::chrono::milliseconds interval )
+{
+	// the rate of a report is over the time since the one before
+	if (callback && interval <= std::chrono::milliseconds::zero())
+		throw("Progress interval must be positive");
+	progress = callback;
+	progressInterval = interval;
+	searchStart = lastProgress = std::chrono::steady_clock::now();
+	lastProgressNodes = nodes;
+}
+
+void RushHourSolver::Options ( SolveOptions const & options )
+{
+	Deadline(options.deadline);
+	Cancellation(options.token);
+	Progress(options.progress, options.progressInterval);
+	MemoryBudget(options.memoryBudget);
+	Timeline(options.timeline);
+}
+
+size_t RushHourSolver::StateBytes ( ) const
+{
+	return currentCarLocations.size() * sizeof(CarLocations::value_type) + allocationOverhead;
+}
+
+void RushHourSolver::AccountRecursion ( MoveList const & solution )
+{
+	memory.visited.Set(stateHistory.Bytes());
+	memory.closedList.Set(closedList.Bytes());
+	memory.frontier.Set(PathsBytes(frontier) + PathsBytes(checkpoint));
+	memory.moveBuffers.Set(currentLevel * (moveOrdering == blockerOrder ? frameBytes : sizeof(MoveCursor)));
+	memory.path.Set(solution.capacity() * sizeof(MoveList::value_type));
+	size_t total = memory.visited.current + memory.closedList.current + memory.frontier.current
+		+ memory.moveBuffers.current + memory.path.current;
+	memory.total.Set(total);
+	if (memoryBudget == 0 || total <= memoryBudget)
+		return;
+	memory.overBudget = true;
+
+	// the next iteration starts from the root instead, the checkpoint being searched is kept
+	if (!frontier.empty() || recordFrontier) {
+		memory.frontierDropped = true;
+		recordFrontier = false;
+		total -= PathsBytes(frontier);
+		std::vector<MoveList>().swap(frontier);
+		if (total <= memoryBudget)
+			return;
+	}
+
+	// a quarter below the budget so the next check doesn't evict again right away
+	size_t target = memoryBudget - memoryBudget / 4;
+	if (!closedList.Empty()) {
+		EvictClosedList(total - target);
+	}
+	else if (closedListEnabled) {
+		// nothing left to evict, the path and the frames alone are over the budget
+		memory.closedListDropped = true;
+		closedListEnabled = false;
+		closedList.Release();
+	}
+	memory.closedList.current = closedList.Bytes();
+	memory.total.current = memory.visited.current + memory.closedList.current + memory.frontier.current
+		+ memory.moveBuffers.current + memory.path.current;
+}
+
+void RushHourSolver::AccountFilter ( size_t frames, MoveList const & solution )
+{
+	memory.visited.Set(0);
+	memory.closedList.Set(filter.Bytes());
+	memory.frontier.Set(0);
+	memory.moveBuffers.Set(frames * sizeof(MoveCursor));
+	memory.path.Set(solution.capacity() * sizeof(MoveList::value_type));
+	memory.total.Set(memory.closedList.current + memory.moveBuffers.current + memory.path.current);
+
+	// what the closed list of Search would keep
+	size_t exact = filter.States() * closedList.BytesPerState();
+	memory.filterStates = filter.States();
+	memory.filterSavedBytes = exact > filter.Bytes() ? exact - filter.Bytes() : 0;
+	memory.falsePrunes = filter.FalsePrunes();
+}
+
+void RushHourSolver::EvictClosedList ( size_t bytes )
+{
+	size_t entryBytes = closedList.Bytes() / closedList.Size();
+	size_t evict = std::min(closedList.Size(), bytes / entryBytes + 1);
+
+	// the entries with the fewest moves left save the least work
+	std::vector<unsigned> remaining;
+	remaining.reserve(closedList.Size());
+	for (size_t index = 0; index < closedList.Size(); ++index) {
+		remaining.push_back(closedList.Value(index));
+	}
+	std::nth_element(remaining.begin(), remaining.begin() + static_cast<std::ptrdiff_t>(evict - 1), remaining.end());
+	unsigned threshold = remaining[evict - 1];
+	size_t below = static_cast<size_t>(std::count_if(remaining.begin(), remaining.end(), [threshold](unsigned r) { return r < threshold; }));
+
+	// everything below the threshold and as many at the threshold as needed
+	size_t atThreshold = evict - below;
+	closedList.RemoveIf([threshold, &atThreshold](unsigned r) {
+		if (r < threshold)
+			return true;
+		if (r == threshold && atThreshold > 0) {
+			--atThreshold;
+			return true;
+		}
+		return false;
+	});
+	memory.evictedEntries += evict;
+}
+
+bool RushHourSolver::FallBack ( MoveList & solution )
+{
+	if (!overBudget || stopped)
+		return false;
+	overBudget = false;
+	memory.fellBack = true;
+	return SolveIterativeDeepening(solution);
+}
+
+bool RushHourSolver::SolveBestFirst ( MoveList & solution )
+{
+	return SolveGraphSearch(solution, false) || FallBack(solution);
+}
+
+bool RushHourSolver::SolveBreadthFirst ( MoveList & solution )
+{
+	return SolveGraphSearch(solution, true) || FallBack(solution);
+}
+
+bool RushHourSolver::SolveGraphSearch ( MoveList & solution, bool breadthFirst )
+{
+	PhaseScope phase(timeline, breadthFirst ? "breadth first" : "best first", "search");
+	BeginSolve();
+	// every generated state once, parents point back into the same vector
+	struct Node {
+		CarLocations locations;
+		size_t parent;
+		std::tuple<unsigned, Direction, unsigned> move;
+		unsigned depth;
+	};
+	// (score, depth, node) - lowest score first, shallower first on ties
+	// breadth-first uses (depth, 0, node) so it is a plain FIFO
+	typedef std::tuple<unsigned, unsigned, size_t> QueueEntry;
+
+	std::vector<Node> states;
+	std::unordered_multimap<StateHash, size_t> seen;
+	std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> open;
+
+	CarLocations start = currentCarLocations;
+	Node root = { start, 0, std::tuple<unsigned, Direction, unsigned>(0, undefined, 0), 0 };
+	states.push_back(root);
+	seen.insert(std::make_pair(stateHash, 0));
+	open.push(QueueEntry(breadthFirst ? 0 : BlockerScore(), 0, 0));
+
+	// every state is kept until the end, nothing can be given up over the budget
+	auto overMemoryBudget = [&]() {
+		memory.visited.Set(states.capacity() * sizeof(Node) + states.size() * StateBytes() + HashMapBytes(seen, 0));
+		memory.closedList.Set(closedList.Bytes());
+		memory.frontier.Set(open.size() * sizeof(QueueEntry));
+		memory.moveBuffers.Set(frameBytes);
+		memory.path.Set(0);
+		memory.total.Set(memory.visited.current + memory.closedList.current + memory.frontier.current + frameBytes);
+		return memoryBudget > 0 && memory.total.current > memoryBudget;
+	};
+
+	size_t goal = 0;
+	bool found = IsSolved();
+	while (!open.empty() && !found && !stopped) {
+		size_t current = std::get<2>(open.top());
+		open.pop();
+		PlaceState(states[current].locations);
+
+		if ((++nodes & 4095) == 0) {
+			if (overMemoryBudget()) {
+				memory.overBudget = overBudget = true;
+				break;
+			}
+			CheckLimits(states[current].depth, states.size());
+		}
+
+		PossibleMoveVector possibleMoves;
+		ReverseMoveVector reverseMoves;
+		CalculatePossibleMoves(possibleMoves, reverseMoves);
+
+		while (!possibleMoves.empty() && !found) {
+			std::tuple<unsigned, Direction, unsigned> move = possibleMoves.back();
+			possibleMoves.pop_back();
+			MoveCar(move);
+
+			bool known = false;
+			std::pair<std::unordered_multimap<StateHash, size_t>::iterator, std::unordered_multimap<StateHash, size_t>::iterator> range = seen.equal_range(stateHash);
+			for (auto iter = range.first; iter != range.second && !known; ++iter) {
+				known = states[iter->second].locations == currentCarLocations;
+			}
+			if (!known) {
+				Node node = { currentCarLocations, current, move, states[current].depth + 1 };
+				states.push_back(node);
+				seen.insert(std::make_pair(stateHash, states.size() - 1));
+				if (IsSolved()) {
+					found = true;
+					goal = states.size() - 1;
+				}
+				else {
+					if (breadthFirst)
+						open.push(QueueEntry(node.depth, 0, states.size() - 1));
+					else
+						open.push(QueueEntry(BlockerScore(), node.depth, states.size() - 1));
+				}
+			}
+
+			MoveCar(reverseMoves.back());
+			reverseMoves.pop_back();
+		}
+	}
+
+	if (found) {
+		PhaseScope reconstruction(timeline, "path");
+		MoveList path;
+		for (size_t node = goal; node != 0; node = states[node].parent) {
+			path.push_back(states[node].move);
+		}
+		solution.assign(path.rbegin(), path.rend());
+		ToCarIds(solution);
+	}
+	if (!overBudget)
+		overMemoryBudget(); // the peak of searches shorter than the check interval
+	PlaceState(start);
+	phase.Arg("nodes", nodes);
+	phase.Arg("states", states.size());
+	phase.Arg("moves", solution.size());
+	return found;
+}
+
+bool RushHourSolver::SolveIterativeDeepening ( MoveList & solution )
+{
+	unsigned maxLevel = 1;
+	bool done = false;
+	bool resume = false;
+	SearchFunction search = SelectSearch(false);
+	PhaseScope phase(timeline, "iterative deepening", "search");
+	BeginSolve();
+	ClearClosedList();
+	// loop through until it's solved
+	// Warning: I'm not checking for a max level so it'll crash if the max depth is high
+	do {
+		PhaseScope iteration(timeline, "iteration", "iteration");
+		unsigned long long iterationNodes = nodes;
+		MaxIteration(++maxLevel);
+		frontier.clear();
+		recordFrontier = frontierLimit > 0 && !memory.frontierDropped;
+
+		if (resume) {
+			for (size_t i = 0; i < checkpoint.size() && !done && !stopped; ++i) {
+				done = ResumeFrom(checkpoint[i], solution, search);
+			}
+		}
+		else {
+			done = (this->*search)(solution);
 		}
 
-		std::tuple<unsigned, Direction, unsigned> reverseMove = reverseMoves.back();
-		reverseMoves.pop_back();
+		// the frontier and the closed list are at their largest here
+		AccountRecursion(solution);
+
+		// frontier is complete only if nothing was dropped
+		resume = recordFrontier;
+		checkpoint.swap(frontier);
+
+		// nothing was cut off, a deeper iteration has no new paths to search
+		if (resume && checkpoint.empty() && !done && !stopped)
+			stopped = unsolvable = true;
+
+		iteration.Arg("depth", maxLevel);
+		iteration.Arg("nodes", nodes - iterationNodes);
+		iteration.Arg("closed list", closedList.Size());
+		iteration.Arg("frontier", checkpoint.size());
+	} while (!done && !stopped);
+
+	recordFrontier = false;
+	frontier.clear();
+	checkpoint.clear();
+	{
+		PhaseScope path(timeline, "path");
+		ToCarIds(solution);
+	}
+	phase.Arg("nodes", nodes);
+	phase.Arg("iterations", maxLevel - 1);
+	phase.Arg("moves", solution.size());
+	// the component check explored from the root, its goal depth is the length of a shortest solution
+	if (componentExplored && component.solvable)
+		phase.Arg("shortest", component.goalDepth);
+	return done;
+}
 
-		makeMove(reverseMove);
+bool RushHourSolver::ResumeFrom ( MoveList const & path, MoveList & solution, SearchFunction search )
+{
+	for (std::tuple<unsigned, Direction, unsigned> const & move : path) {
+		MoveCar(move);
+		if (trace) {
+			trace->Move(CarIdMove(move));
+		}
+		stateHistory.Insert(stateHash, Key());
+		solution.push_back(move);
+		++currentLevel;
+	}
+
+	if ((this->*search)(solution))
+		return true;
 
+	// roll back to the root
+	for (MoveList::const_reverse_iterator iter = path.rbegin(); iter != path.rend(); ++iter) {
+		stateHistory.Erase(stateHash, Key());
+		std::tuple<unsigned, Direction, unsigned> reverseMove = ReverseMove(*iter);
+		MoveCar(reverseMove);
+		if (trace) {
+			trace->Move(CarIdMove(reverseMove));
+		}
+		solution.pop_back();
+		--currentLevel;
 	}
-#if CLOSED_LIST_OPT
-	closedList.push_back(ClosedListSearchNode(currentCarLocations, solution.size()));
-#endif
 	return false;
 }
 
+ComponentReport RushHourSolver::ExploreComponent ( )
+{
+	unsigned bits = PositionBits(height, width);
+	if (Packable())
+		return ExploreComponent<std::uint64_t>(bits);
+	return ExploreComponent<std::string>(bits);
+}
+
+bool RushHourSolver::Packable ( ) const
+{
+	return currentCarLocations.size() * PositionBits(height, width) <= 64;
+}
+
+std::uint64_t RushHourSolver::Pack ( ) const
+{
+	std::uint64_t packed;
+	PackState(currentCarLocations, PositionBits(height, width), packed);
+	return packed;
+}
+
+void RushHourSolver::Unpack ( std::uint64_t packed )
+{
+	UnpackState(packed, PositionBits(height, width), currentCarLocations);
+	LoadState(currentCarLocations);
+}
+
+template<typename Packed>
+ComponentReport RushHourSolver::ExploreComponent ( unsigned positionBits )
+{
+	ComponentReport report;
+	CarLocations start = currentCarLocations;
+	CarLocations locations = start;
+	std::unordered_set<Packed> visited;
+	// points into visited, its elements never move
+	std::vector<Packed const *> open;
+	Packed packed;
+	PackState(currentCarLocations, positionBits, packed);
+	open.push_back(&*visited.insert(packed).first);
+	report.solvable = IsSolved();
+
+	unsigned depth = 0;
+	size_t layerEnd = 1;            // open[layerEnd] is the first state one move deeper
+	bool overMemoryBudget = false;
+	// counted apart from the search it may interrupt, it shares the budget with what the
+	// search holds right now
+	auto account = [&]() {
+		memory.component.Set(HashMapBytes(visited, 0) + open.capacity() * sizeof(Packed const *));
+		return memoryBudget > 0 && memory.total.current + memory.component.current > memoryBudget;
+	};
+	for (size_t next = 0; next < open.size() && !report.solvable && !stopped; ++next) {
+		if (next == layerEnd) {
+			++depth;
+			layerEnd = open.size();
+		}
+		if (((next + 1) & 4095) == 0) {
+			if (account()) {
+				memory.overBudget = overMemoryBudget = true;
+				break;
+			}
+			CheckLimits(depth, visited.size());
+		}
+
+		UnpackState(*open[next], positionBits, locations);
+		PlaceState(locations);
+		MoveCursor cursor;
+		StartMoves(cursor, nullptr);
+		std::tuple<unsigned, Direction, unsigned> move;
+		while (!report.solvable && NextMove(cursor, move)) {
+			MoveCar(move);
+			PackState(currentCarLocations, positionBits, packed);
+			std::pair<typename std::unordered_set<Packed>::iterator, bool> inserted = visited.insert(packed);
+			if (inserted.second) {
+				open.push_back(&*inserted.first);
+				if (IsSolved()) {
+					report.solvable = true;
+					report.goalDepth = depth + 1;
+				}
+			}
+			MoveCar(ReverseMove(move));
+		}
+	}
+
+	if (!overMemoryBudget)
+		account();
+	report.states = visited.size();
+	report.complete = !report.solvable && !stopped && !overMemoryBudget;
+	if (report.complete)
+		stopped = unsolvable = true;
+	PlaceState(start);
+	component = report;
+	return report;
+}
+
+bool RushHourSolver::SolveCheapest ( MoveList & solution )
+{
+	BeginSolve();
+	unsigned bits = PositionBits(height, width);
+	if (Packable())
+		return SolveCheapest<std::uint64_t>(solution, bits);
+	return SolveCheapest<std::string>(solution, bits);
+}
+
+template<typename Packed>
+bool RushHourSolver::SolveCheapest ( MoveList & solution, unsigned positionBits )
+{
+	PhaseScope phase(timeline, "cheapest", "search");
+	struct Node {
+		Packed packed;
+		size_t parent;
+		std::tuple<unsigned, Direction, unsigned> move;
+		unsigned long long cost;
+	};
+
+	// price per position by car index
+	std::vector<unsigned> weights(carIds.size());
+	unsigned heaviest = 0;
+	for (unsigned index = 0; index < carIds.size(); ++index) {
+		weights[index] = moveCost.Weight(carIds[index]);
+		heaviest = std::max(heaviest, weights[index]);
+	}
+	// a move is never more than a bucket ring away from the cheapest queued state
+	std::vector<std::vector<size_t>> buckets(moveCost.perMove + heaviest * std::max(height, width) + 1);
+
+	CarLocations start = currentCarLocations;
+	CarLocations locations = start;
+	std::vector<Node> states;
+	std::unordered_map<Packed, size_t> index;
+	Packed packed;
+	PackState(currentCarLocations, positionBits, packed);
+	states.push_back(Node{ packed, 0, std::tuple<unsigned, Direction, unsigned>(0, undefined, 0), 0 });
+	index.insert(std::make_pair(packed, 0));
+	buckets[0].push_back(0);
+	size_t queued = 1;
+
+	size_t goal = 0;
+	bool found = false;
+	bool overMemoryBudget = false;
+	for (unsigned long long cost = 0; queued > 0 && !found && !stopped && !overMemoryBudget; ++cost) {
+		std::vector<size_t> & bucket = buckets[cost % buckets.size()];
+		// free moves land in the bucket being emptied, so no iterators into it
+		for (size_t i = 0; i < bucket.size() && !found && !stopped; ++i) {
+			size_t current = bucket[i];
+			// queued again since at a lower price
+			if (states[current].cost != cost)
+				continue;
+
+			if ((++nodes & 4095) == 0) {
+				memory.visited.Set(states.capacity() * sizeof(Node) + HashMapBytes(index, 0));
+				memory.frontier.Set(queued * sizeof(size_t));
+				memory.total.Set(memory.visited.current + memory.frontier.current);
+				if (memoryBudget > 0 && memory.total.current > memoryBudget) {
+					memory.overBudget = overMemoryBudget = true;
+					break;
+				}
+				CheckLimits(static_cast<unsigned>(std::min<unsigned long long>(cost, std::numeric_limits<unsigned>::max())), states.size());
+			}
+
+			UnpackState(states[current].packed, positionBits, locations);
+			PlaceState(locations);
+			if (IsSolved()) {
+				found = true;
+				goal = current;
+				break;
+			}
+
+			MoveCursor cursor;
+			StartMoves(cursor, nullptr);
+			std::tuple<unsigned, Direction, unsigned> move;
+			while (NextMove(cursor, move)) {
+				unsigned long long price = cost + moveCost.perMove + static_cast<unsigned long long>(weights[std::get<0>(move)]) * std::get<2>(move);
+				MoveCar(move);
+				PackState(currentCarLocations, positionBits, packed);
+				std::pair<typename std::unordered_map<Packed, size_t>::iterator, bool> inserted = index.insert(std::make_pair(packed, states.size()));
+				if (inserted.second)
+					states.push_back(Node{ packed, current, move, price });
+				else if (price < states[inserted.first->second].cost)
+					states[inserted.first->second] = Node{ packed, current, move, price };
+				else
+					inserted.first = index.end();
+				if (inserted.first != index.end()) {
+					buckets[price % buckets.size()].push_back(inserted.first->second);
+					++queued;
+				}
+				MoveCar(ReverseMove(move));
+			}
+		}
+		queued -= bucket.size();
+		bucket.clear();
+	}
+
+	if (found) {
+		PhaseScope reconstruction(timeline, "path");
+		MoveList path;
+		for (size_t node = goal; node != 0; node = states[node].parent) {
+			path.push_back(states[node].move);
+		}
+		solution.assign(path.rbegin(), path.rend());
+		ToCarIds(solution);
+	}
+	// every reachable state was priced, none of them solved
+	else if (queued == 0 && !stopped && !overMemoryBudget) {
+		stopped = unsolvable = true;
+	}
+	PlaceState(start);
+	phase.Arg("nodes", nodes);
+	phase.Arg("states", states.size());
+	phase.Arg("moves", solution.size());
+	return found;
+}
+
 //#TODO need refactoring bad. This entire function is a terrible code block
-void RushHourSolver::InitCarLocations ( ) {
-	// build the initial carInfo vector
+void RushHourSolver::IndexCars ( ) {
+	// find the cars in reading order
+	std::vector<std::pair<unsigned, CarInfo>> found;
 	for (unsigned i = 0; i < height; ++i) {
 		for (unsigned j = 0; j < width; ++j) {
 			if (parkingLot[i][j] != 0) {
@@ -394,41 +1445,136 @@ void RushHourSolver::InitCarLocations ( ) {
 					//Horizontal
 					size = CalculateHorizontalCarSize(i, j, carID);
 					CarInfo info(i, j, size, horisontal);
-					currentCarLocations.push_back(std::make_pair(carID, info));
+					found.push_back(std::make_pair(carID, info));
 				}else if(i == 0 && parkingLot[i + 1][j] == carID) {
 					// Vertical
 					size = CalculateVerticalCarSize(i, j, carID);
 					CarInfo info(i, j, size, vertical);
-					currentCarLocations.push_back(std::make_pair(carID, info));
+					found.push_back(std::make_pair(carID, info));
 
 				}else if (j != width - 1 &&  parkingLot[i][j + 1] == carID && parkingLot[i][j - 1] != carID) {
 					// Horizontal in between
 					size = CalculateHorizontalCarSize(i, j, carID);
 					CarInfo info(i, j, size, horisontal);
-					currentCarLocations.push_back(std::make_pair(carID, info));
+					found.push_back(std::make_pair(carID, info));
 
 				}else if(i != height - 1 && parkingLot[i + 1][j] == carID && parkingLot[i - 1][j] != carID) {
 					// Vertical in between
 					size = CalculateVerticalCarSize(i, j, carID);
 					CarInfo info(i, j, size, vertical);
-					currentCarLocations.push_back(std::make_pair(carID, info));
+					found.push_back(std::make_pair(carID, info));
 				}
 
 			}
 		}
 	}
-	stateHistory.push_back(currentCarLocations);
+
+	std::vector<unsigned> readingOrder;
+	for (std::pair<unsigned, CarInfo> const & pair : found) {
+		readingOrder.push_back(pair.first);
+	}
+
+	// the main car gets index 0, the others follow in reading order
+	std::stable_partition(found.begin(), found.end(), [this](std::pair<unsigned, CarInfo> const & pair) { return pair.first == car; });
+	if (found.empty() || found.front().first != car) {
+		throw "Errors in input file: the car to be navigated is not in the parking lot";
+	}
+	unsigned maxId = 0;
+	for (std::pair<unsigned, CarInfo> const & pair : found) {
+		maxId = std::max(maxId, pair.first);
+	}
+	std::vector<unsigned> indexOf(maxId + 1, noCar);
+	for (unsigned index = 0; index < found.size(); ++index) {
+		indexOf[found[index].first] = index;
+		carIds.push_back(found[index].first);
+		currentCarLocations.push_back(found[index].second);
+	}
+
+	// moves are still generated in reading order
+	for (unsigned carID : readingOrder) {
+		moveOrder.push_back(indexOf[carID]);
+	}
+
+	for (std::vector<unsigned> & row : parkingLot) {
+		for (unsigned & cell : row) {
+			unsigned index = cell == 0 ? noCar : cell <= maxId ? indexOf[cell] : noCar;
+			if (cell != 0 && index == noCar) {
+				throw "Errors in input file: a car has to cover two cells in a line";
+			}
+			cell = index;
+		}
+	}
+}
+
+void RushHourSolver::InitCarLocations ( ) {
+	PhaseScope init(timeline, "init");
+	// fixed seed so hashes are the same from run to run
+	std::mt19937_64 random(0x5eed);
+	zobristKeys.resize(currentCarLocations.size() * height * width);
+	for (StateHash & key : zobristKeys) {
+		key = random();
+	}
+	stateHash = ComputeStateHash();
+
+	stateHistory.Stride(currentCarLocations.size());
+	closedList.Stride(currentCarLocations.size());
+	stateHistory.Insert(stateHash, Key());
+}
+
+char const * RushHourSolver::Key ( )
+{
+	key.resize(currentCarLocations.size());
+	for (size_t index = 0; index < currentCarLocations.size(); ++index) {
+		CarInfo const & info = currentCarLocations[index];
+		key[index] = static_cast<char>(info.orientation == horisontal ? info.column : info.row);
+	}
+	return key.data();
+}
+
+StateHash RushHourSolver::ComputeStateHash() const
+{
+	size_t cells = static_cast<size_t>(height) * width;
+	StateHash hash = 0;
+	for (size_t index = 0; index < currentCarLocations.size(); ++index) {
+		CarInfo const & info = currentCarLocations[index];
+		hash ^= zobristKeys[index * cells + info.row * width + info.column];
+	}
+	return hash;
+}
+
+std::tuple<unsigned, Direction, unsigned> RushHourSolver::CarIdMove ( std::tuple<unsigned, Direction, unsigned> const & move ) const
+{
+	return std::tuple<unsigned, Direction, unsigned>(carIds[std::get<0>(move)], std::get<1>(move), std::get<2>(move));
+}
+
+void RushHourSolver::ToCarIds ( MoveList & moves ) const
+{
+	for (std::tuple<unsigned, Direction, unsigned> & move : moves) {
+		std::get<0>(move) = carIds[std::get<0>(move)];
+	}
 }
 
 void RushHourSolver::ClearClosedList()
 {
-	closedList.clear();
+	closedList.Clear();
 }
 
+void RushHourSolver::Filter ( size_t expectedStates, double falsePositiveRate ) {
+	filter = expectedStates ? VisitedFilter(expectedStates, falsePositiveRate) : VisitedFilter();
+	memory.filterStates = memory.filterSavedBytes = 0;
+	memory.falsePrunes = 0;
+}
 void RushHourSolver::MaxIteration ( unsigned iter ) {
 	maxIterationLevel = iter;
 }
 
+void RushHourSolver::Trace ( TraceWriter * writer ) {
+	trace = writer;
+	if (trace) {
+		trace->Start(Board());
+	}
+}
+
 unsigned RushHourSolver::CalculateHorizontalCarSize ( unsigned x, unsigned y, unsigned carID) {
 	unsigned counter = 0;
 	while(y + counter < width && parkingLot[x][y + (counter)] == carID) {
@@ -448,31 +1594,21 @@ unsigned RushHourSolver::CalculateVerticalCarSize ( unsigned x, unsigned y, unsi
 
 void RushHourSolver::PrintPossibleMoves(PossibleMoveVector& moves ) const
 {
-#if LOG_ENABLED
 	std::cout << std::endl;
-	for (unsigned i = moves.size() - 1; i != -1; --i) {
+	for (size_t i = moves.size(); i-- > 0; ) {
 		PrintMove(moves[i]);
 	}
-#else
-	static_cast<void>(moves);
-#endif
 }
 
 void RushHourSolver::PrintMove ( std::tuple<unsigned, Direction, unsigned> const & move) const {
-#if LOG_ENABLED
 	unsigned carID = std::get<0>(move);
 	Direction direction = std::get<1>(move); // convert direction to int
 	unsigned positions = std::get<2>(move);
 
-	std::cout << "Car with ID: " << carID << " can move " << positions << " steps towards " << direction << std::endl;
-#else
-	static_cast<void>(move);
-#endif// LOG_ENABLED
-
+	std::cout << "Car with ID: " << carIds[carID] << " can move " << positions << " steps towards " << direction << std::endl;
 }
 
 void RushHourSolver::PrintMap ( ) const {
-#if LOG_ENABLED
 	std::cout << std::endl;
 	std::cout << "    ";
 	for (unsigned i = 0; i < width; ++i) {
@@ -483,12 +1619,11 @@ void RushHourSolver::PrintMap ( ) const {
 	for (unsigned i = 0; i<height; ++i) {
 		std::cout << i << " | ";
 		for (unsigned j = 0; j<width; ++j) {
-			std::cout << parkingLot[i][j] << " ";
+			std::cout << (parkingLot[i][j] == noCar ? 0 : carIds[parkingLot[i][j]]) << " ";
 		}
 		std::cout << std::endl;
 	}
 	std::cout << std::endl;
-#endif
 }
 
 RushHourSolver::~RushHourSolver()
@@ -496,55 +1631,91 @@ RushHourSolver::~RushHourSolver()
 }
 
 // #TODO This function also needs refactoring bad.
-void RushHourSolver::CalculatePossibleMoves (PossibleMoveVector& possibleMoves, ReverseMoveVector& reverseMoves) {
-	CarLocations::iterator iter = currentCarLocations.begin();
-	CarLocations::iterator end = currentCarLocations.end();
-
-	while(iter != end) {
-		CarInfo * carInfo = &iter->second;
-		unsigned carColumn = carInfo->column;
-		unsigned carRow = carInfo->row;
-		unsigned carID = iter->first;
-
-		// Horizontal cars
-		if(carInfo->orientation == horisontal) {
-			unsigned counter = 1;
-			unsigned last = carColumn + carInfo->size;
-			// If it's a valid move
-			// tail of a car
-			while (last < width && parkingLot[carRow][last++] == 0) {
-				possibleMoves.push_front(std::tuple<unsigned, Direction, unsigned>(carID, right, counter));
-				reverseMoves.push_front(std::tuple<unsigned, Direction, unsigned>(carID, left, counter));
-				++counter;
-			}
-			int begin = carColumn - 1;
-			counter = 1;
-			// head of a car
-			while (begin > -1 && parkingLot[carRow][begin--] == 0) {
-				possibleMoves.push_front(std::tuple<unsigned, Direction, unsigned>(carID, left, counter));
-				reverseMoves.push_front(std::tuple<unsigned, Direction, unsigned>(carID, right, counter));
-				++counter;
+void RushHourSolver::CalculatePossibleMoves (PossibleMoveVector& possibleMoves, ReverseMoveVector& reverseMoves,
+                                             std::tuple<unsigned, Direction, unsigned> const * previous) {
+	MoveCursor cursor;
+	StartMoves(cursor, previous);
+	std::tuple<unsigned, Direction, unsigned> move;
+	// moves are taken from the back, the first one generated goes last
+	while (NextMove(cursor, move)) {
+		possibleMoves.push_front(move);
+		reverseMoves.push_front(ReverseMove(move));
+	}
+}
+
+void RushHourSolver::StartMoves ( MoveCursor & cursor, std::tuple<unsigned, Direction, unsigned> const * previous ) const
+{
+	cursor = MoveCursor();
+	if (!previous)
+		return;
+	// the car already moved, sweeping back covers the same cells
+	cursor.previousCar = std::get<0>(*previous);
+	cursor.previousId = carIds[cursor.previousCar];
+	cursor.previousCells = SweptCells(currentCarLocations[cursor.previousCar], static_cast<Direction>((std::get<1>(*previous) + 2) % 4), std::get<2>(*previous));
+}
+
+void RushHourSolver::ListMoves ( MoveList & moves, std::tuple<unsigned, Direction, unsigned> const * previous ) const
+{
+	MoveCursor cursor;
+	StartMoves(cursor, previous);
+	std::tuple<unsigned, Direction, unsigned> move;
+	while (NextMove(cursor, move)) {
+		moves.push_back(move);
+	}
+}
+
+bool RushHourSolver::NextMove ( MoveCursor & cursor, std::tuple<unsigned, Direction, unsigned> & move ) const
+{
+	while (cursor.next < moveOrder.size()) {
+		unsigned index = moveOrder[cursor.next];
+		CarInfo const & info = currentCarLocations[index];
+
+		// A second move of the same car right after the first is never needed, a single
+		// move gets there in fewer steps.
+		if (index == cursor.previousCar)
+			cursor.phase = 2;
+
+		if (cursor.phase < 2) {
+			bool horizontal = info.orientation == horisontal;
+			unsigned positions = ++cursor.positions;
+			// first cell in the way: past the tail (right/down) or before the head (left/up)
+			unsigned row = info.row;
+			unsigned column = info.column;
+			bool inside;
+			if (cursor.phase == 0) {
+				if (horizontal)
+					column += info.size - 1 + positions;
+				else
+					row += info.size - 1 + positions;
+				inside = horizontal ? column < width : row < height;
 			}
-		}else { //same for vertical
-			unsigned counter = 1;
-			unsigned last = carRow + carInfo->size;
-			while (last < height && parkingLot[last++][carColumn] == 0) {
-				possibleMoves.push_front(std::tuple<unsigned, Direction, unsigned>(carID, down, counter));
-				reverseMoves.push_front(std::tuple<unsigned, Direction, unsigned>(carID, up, counter));
-				++counter;
+			else {
+				inside = positions <= (horizontal ? column : row);
+				if (horizontal)
+					column -= positions;
+				else
+					row -= positions;
 			}
-			int begin = carRow - 1;
-			counter = 1;
-			while (begin > -1 && parkingLot[begin--][carColumn] == 0) {
-				possibleMoves.push_front(std::tuple<unsigned, Direction, unsigned>(carID, up, counter));
-				reverseMoves.push_front(std::tuple<unsigned, Direction, unsigned>(carID, down, counter));
-				++counter;
+			if (!inside || parkingLot[row][column] != noCar) {
+				++cursor.phase;
+				cursor.positions = 0;
+				continue;
 			}
+
+			Direction d = cursor.phase == 0 ? (horizontal ? right : down) : (horizontal ? left : up);
+			// Two moves commute when their swept cells do not meet; of the two orders only
+			// the one moving the lower numbered car first is searched.
+			if (carIds[index] < cursor.previousId && !SweptCells(info, d, positions).Overlaps(cursor.previousCells))
+				continue;
+			move = std::tuple<unsigned, Direction, unsigned>(index, d, positions);
+			return true;
 		}
 
-		++iter;
+		++cursor.next;
+		cursor.phase = 0;
+		cursor.positions = 0;
 	}
-
+	return false;
 }
 
 void RushHourSolver::Print(std::string const& filename_out) const
@@ -554,7 +1725,7 @@ void RushHourSolver::Print(std::string const& filename_out) const
 	os << std::endl;
 	for (unsigned i = 0; i<height; ++i) {
 		for (unsigned j = 0; j<width; ++j) {
-			os << parkingLot[i][j] << " ";
+			os << (parkingLot[i][j] == noCar ? 0 : carIds[parkingLot[i][j]]) << " ";
 		}
 		os << std::endl;
 	}
@@ -562,20 +1733,172 @@ void RushHourSolver::Print(std::string const& filename_out) const
 }
 
 void RushHourSolver::PrintCarLocations ( ) const {
-#if LOG_ENABLED
-	CarLocations::const_iterator iter = currentCarLocations.begin();
-	CarLocations::const_iterator end = currentCarLocations.end();
-	while (iter != end) {
-		iter->second.PrintCarInfo(iter->first);
-		++iter;
+	for (unsigned index = 0; index < currentCarLocations.size(); ++index) {
+		currentCarLocations[index].PrintCarInfo(carIds[index]);
+	}
+}
+
+size_t StateTable::Probe ( StateHash hash, char const * state ) const
+{
+	size_t mask = slots.size() - 1;
+	for (size_t slot = hash & mask; ; slot = (slot + 1) & mask) {
+		Slot const & entry = slots[slot];
+		if (entry.epoch != epoch)
+			return slot;
+		if (entry.hash == hash && std::equal(state, state + stride, arena.begin() + static_cast<std::ptrdiff_t>(entry.state * stride)))
+			return slot;
+	}
+}
+
+size_t StateTable::Find ( StateHash hash, char const * state ) const
+{
+	if (count == 0)
+		return noState;
+	Slot const & entry = slots[Probe(hash, state)];
+	return entry.epoch == epoch ? entry.state : noState;
+}
+
+size_t StateTable::Insert ( StateHash hash, char const * state, std::uint32_t value )
+{
+	// at most three quarters full, so a probe always ends at an empty slot
+	if ((count + 1) * 4 > slots.size() * 3)
+		Grow();
+	if (hashes.size() == count) {
+		size_t size = std::max<size_t>(count * 2, 16);
+		arena.resize(size * stride);
+		hashes.resize(size);
+		values.resize(size);
+	}
+	std::copy(state, state + stride, arena.begin() + static_cast<std::ptrdiff_t>(count * stride));
+	hashes[count] = hash;
+	values[count] = value;
+	slots[Probe(hash, state)] = Slot{ hash, static_cast<std::uint32_t>(count), epoch };
+	return count++;
+}
+
+void StateTable::Set ( StateHash hash, char const * state, std::uint32_t value )
+{
+	size_t index = Find(hash, state);
+	if (index == noState)
+		Insert(hash, state, value);
+	else
+		values[index] = value;
+}
+
+void StateTable::Erase ( StateHash hash, char const * state )
+{
+	size_t mask = slots.size() - 1;
+	size_t hole = Probe(hash, state);
+	size_t index = slots[hole].state;
+
+	// later states of the probe sequence move up into the hole (backward shift deletion)
+	for (size_t slot = (hole + 1) & mask; slots[slot].epoch == epoch; slot = (slot + 1) & mask) {
+		size_t home = slots[slot].hash & mask;
+		if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+			slots[hole] = slots[slot];
+			hole = slot;
+		}
 	}
-#endif // LOG_ENABLED
+	slots[hole].epoch = epoch - 1;
+
+	// the last state fills the gap in the arena
+	size_t last = count - 1;
+	if (index != last) {
+		char const * moved = &arena[last * stride];
+		Slot & entry = slots[Probe(hashes[last], moved)];
+		std::copy(moved, moved + stride, arena.begin() + static_cast<std::ptrdiff_t>(index * stride));
+		hashes[index] = hashes[last];
+		values[index] = values[last];
+		entry.state = static_cast<std::uint32_t>(index);
+	}
+	--count;
+}
 
+void StateTable::Grow ( )
+{
+	std::vector<Slot>(std::max<size_t>(slots.size() * 2, 16), Slot{ 0, 0, 0 }).swap(slots);
+	epoch = 1;
+	Reindex();
 }
 
-bool ClosedListSearchNode::operator==(CarLocations const & rhs) const
+void StateTable::Reindex ( )
 {
-	return carLocation == rhs;
+	size_t mask = slots.size() - 1;
+	for (size_t index = 0; index < count; ++index) {
+		size_t slot = hashes[index] & mask;
+		while (slots[slot].epoch == epoch)
+			slot = (slot + 1) & mask;
+		slots[slot] = Slot{ hashes[index], static_cast<std::uint32_t>(index), epoch };
+	}
 }
 
-ClosedListSearchNode::ClosedListSearchNode ( CarLocations location, size_t size ) :carLocation(location), solSize(size) {}
+void StateTable::Clear ( )
+{
+	count = 0;
+	// the slots of every epoch so far are empty now, a wrapped counter has to wipe them
+	if (++epoch == 0) {
+		std::fill(slots.begin(), slots.end(), Slot{ 0, 0, 0 });
+		epoch = 1;
+	}
+}
+
+void StateTable::Release ( )
+{
+	count = 0;
+	std::vector<char>().swap(arena);
+	std::vector<StateHash>().swap(hashes);
+	std::vector<std::uint32_t>().swap(values);
+	std::vector<Slot>().swap(slots);
+	epoch = 1;
+}
+
+size_t StateTable::Bytes ( ) const
+{
+	return arena.capacity() + hashes.capacity() * sizeof(StateHash) + values.capacity() * sizeof(std::uint32_t)
+		+ slots.capacity() * sizeof(Slot);
+}
+
+VisitedFilter::VisitedFilter ( size_t expectedStates, double falsePositiveRate )
+{
+	if (!(falsePositiveRate > 0 && falsePositiveRate < 1))
+		throw "False positive rate has to be between 0 and 1";
+	// the usual sizing: -n ln p / ln^2 2 bits, ln 2 bits per state per hash
+	double ln2 = std::log(2.0);
+	double bitsNeeded = -static_cast<double>(std::max<size_t>(expectedStates, 1)) * std::log(falsePositiveRate) / (ln2 * ln2);
+	size_t words = static_cast<size_t>(std::ceil(bitsNeeded / 64));
+	bits.assign(std::max<size_t>(words, 1), 0);
+	bitCount = static_cast<std::uint64_t>(bits.size()) * 64;
+	hashes = std::max(1u, static_cast<unsigned>(std::lround(-std::log(falsePositiveRate) / ln2)));
+}
+
+bool VisitedFilter::Insert ( StateHash hash )
+{
+	// double hashing, the second hash is odd so it cycles through the bits
+	std::uint64_t second = hash * 0x9E3779B97F4A7C15ULL;
+	second = (second ^ (second >> 29)) * 0xBF58476D1CE4E5B9ULL;
+	second = (second ^ (second >> 32)) | 1;
+
+	double rate = FalsePositiveRate();
+	bool added = false;
+	for (unsigned i = 0; i < hashes; ++i) {
+		std::uint64_t bit = (hash + i * second) % bitCount;
+		std::uint64_t & word = bits[bit >> 6];
+		std::uint64_t mask = static_cast<std::uint64_t>(1) << (bit & 63);
+		if (!(word & mask)) {
+			word |= mask;
+			++setBits;
+			added = true;
+		}
+	}
+	if (!added)
+		return false;
+	// for every state that got in, rate / (1 - rate) new ones were turned away on average
+	++states;
+	falsePrunes += rate / (1 - rate);
+	return true;
+}
+
+double VisitedFilter::FalsePositiveRate ( ) const
+{
+	return std::pow(static_cast<double>(setBits) / static_cast<double>(bitCount), static_cast<double>(hashes));
+}
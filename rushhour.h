@@ -18,7 +18,15 @@
 #include <limits>
 #include <fstream>
 #include <regex>
-#include <list>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
+#include <chrono>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <algorithm>
+#include <type_traits>
 
 // Keep this
 enum Direction   { up, left, down, right, undefined };
@@ -38,6 +46,129 @@ SolveRushHour( std::string const& filename );
 std::vector< std::tuple<unsigned, Direction, unsigned> > 
 SolveRushHourOptimally( std::string const& filename );
 
+class TraceWriter;
+class PhaseTimeline;
+
+// same as above, every move the search makes (undo moves too) is recorded into trace.
+// Best-first jumps between states, so the traced SolveRushHour is the plain DFS.
+std::vector< std::tuple<unsigned, Direction, unsigned> > 
+SolveRushHour( std::string const& filename, TraceWriter & trace );
+
+std::vector< std::tuple<unsigned, Direction, unsigned> > 
+SolveRushHourOptimally( std::string const& filename, TraceWriter & trace );
+
+// Stops a running search from any thread. Copies share the same flag.
+class CancellationToken {
+private:
+	std::shared_ptr<std::atomic<bool>> flag = std::make_shared<std::atomic<bool>>(false);
+
+public:
+	void Cancel() { flag->store(true, std::memory_order_relaxed); }
+	bool IsCancelled() const { return flag->load(std::memory_order_relaxed); }
+};
+
+// Snapshot of a running search handed to the progress callback
+struct SearchProgress {
+	unsigned depth;                 // length of the path being searched (of the expanded state for BFS)
+	unsigned iteration;             // depth bound of iterative deepening, 0 for the other searches
+	unsigned long long nodes;       // nodes searched so far
+	double nodesPerSecond;          // since the last report
+	size_t closedListSize;          // closed list entries, visited states for BFS and best-first
+	double seconds;                 // since the search started
+	size_t memoryBytes;             // estimated bytes of the search structures, see MemoryUsage
+};
+
+// Current and peak bytes of one search structure
+struct MemoryCounter {
+	size_t current = 0;
+	size_t peak = 0;
+
+	void Set(size_t bytes) { current = bytes; peak = bytes > peak ? bytes : peak; }
+};
+
+// Estimated bytes of the search structures since the solver was created. Estimated from
+// the element counts, container node sizes and bucket arrays every few thousand nodes,
+// so a budget can be overshot by the states of that many nodes.
+struct MemoryUsage {
+	MemoryCounter visited;          // states on the path (DFS), every generated state (BFS, best-first)
+	MemoryCounter closedList;
+	MemoryCounter frontier;         // checkpointed paths of iterative deepening, open list of BFS and best-first
+	MemoryCounter moveBuffers;      // possible and reverse moves of the frames of the recursion
+	MemoryCounter path;             // solution being built
+	MemoryCounter total;
+	MemoryCounter component;        // ExploreComponent, apart from total: it runs on its own, not next to the search structures
+
+	// what was given up to stay in the budget
+	bool overBudget = false;        // the budget was hit
+	bool frontierDropped = false;   // iterative deepening stopped checkpointing the frontier
+	size_t evictedEntries = 0;      // closed list entries evicted, the ones with the fewest moves left first
+	bool closedListDropped = false; // the closed list was turned off, plain iterative deepening from then on
+	bool fellBack = false;          // BFS or best-first gave up and iterative deepening finished the search
+
+	// Bloom filter visited set of depth first search (see RushHourSolver::Filter)
+	size_t filterStates = 0;        // states the filter took in
+	size_t filterSavedBytes = 0;    // what a closed list of those states would take, less the filter
+	double falsePrunes = 0;         // estimated new states pruned as visited ones
+};
+
+// What RushHourSolver::ExploreComponent found out about the states reachable from the current one
+struct ComponentReport {
+	bool solvable = false;          // a solved state was reached, the exploration stopped at the first one
+	bool complete = false;          // every reachable state was visited, without a solved one among them
+	size_t states = 0;              // states visited, the size of the component when complete
+	unsigned goalDepth = 0;         // moves to the first solved state when solvable
+};
+
+typedef std::function<void(SearchProgress const &)> ProgressCallback;
+
+struct SolveOptions {
+	CancellationToken token = CancellationToken();
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+	ProgressCallback progress = ProgressCallback();  // called on the solving thread, empty for none
+	std::chrono::milliseconds progressInterval = std::chrono::milliseconds(250); // positive, Options throws otherwise
+	size_t memoryBudget = 0;        // bytes the search structures may use, 0 for no limit
+	size_t filterStates = 0;        // SolveRushHour only: depth first with a Bloom filter visited set sized for this many states, 0 for exact
+	double falsePositiveRate = 0.001; // of that filter
+	PhaseTimeline * timeline = nullptr; // records parsing, the search and its iterations when set (see phases.h)
+};
+
+// same as above, but stop once the token is cancelled or the deadline passes and report
+// progress at most once per progressInterval. A stopped search returns no moves.
+std::vector< std::tuple<unsigned, Direction, unsigned> > 
+SolveRushHour( std::string const& filename, SolveOptions const & options );
+
+std::vector< std::tuple<unsigned, Direction, unsigned> > 
+SolveRushHourOptimally( std::string const& filename, SolveOptions const & options );
+
+// Price of a move for the cheapest solutions: perMove plus the weight of the car for every
+// position it moves. The default prices the cells moved, {1, 0} the moves like above.
+struct MoveCost {
+	unsigned perMove = 0;
+	unsigned perCell = 1;           // weight of the cars carWeights has none for
+	std::vector<unsigned> carWeights = std::vector<unsigned>(); // by car number
+
+	MoveCost(unsigned perMove = 0, unsigned perCell = 1) : perMove(perMove), perCell(perCell) {}
+
+	unsigned Weight(unsigned car) const { return car < carWeights.size() ? carWeights[car] : perCell; }
+	unsigned Price(std::tuple<unsigned, Direction, unsigned> const & move) const { return perMove + Weight(std::get<0>(move)) * std::get<2>(move); }
+
+	/**
+	 * @brief Price of a whole solution
+	 * @param solution Moves by car number
+	 * @return Sum of the prices of the moves
+	 */
+	unsigned long long Total(std::vector<std::tuple<unsigned, Direction, unsigned>> const & solution) const {
+		unsigned long long total = 0;
+		for (std::tuple<unsigned, Direction, unsigned> const & move : solution)
+			total += Price(move);
+		return total;
+	}
+};
+
+// solution with the lowest total price instead of the fewest moves
+std::vector< std::tuple<unsigned, Direction, unsigned> > 
+SolveRushHourCheapest( std::string const& filename, MoveCost const & cost = MoveCost(), SolveOptions const & options = SolveOptions() );
+
 ////////////////////////////////////////////////////////////////////////////////
 // your stuff
 ////////////////////////////////////////////////////////////////////////////////
@@ -60,56 +191,515 @@ struct CarInfo {
 // returned solution typedef
 typedef std::vector<std::tuple<unsigned, Direction, unsigned>> MoveList;
 
+// Move that takes the given move back, the same car and positions the other way
+std::tuple<unsigned, Direction, unsigned> ReverseMove(std::tuple<unsigned, Direction, unsigned> const & move);
+
 // changed "unsigned **" to this #STLRulezzz
 typedef std::vector<std::vector<unsigned>> ParkingLotMap;
 
 // typedefs for data containers
-typedef std::vector<std::pair<unsigned, CarInfo>> CarLocations;
-typedef std::vector<CarLocations> StateHistory; // to prevent infinite loops
+// Cars are indexed densely in the solver, the main car is 0. The car numbers of the file
+// only show up in the moves and boards handed out (see RushHourSolver::CarId).
+typedef std::vector<CarInfo> CarLocations;
+
+// parking lot cell without a car
+unsigned const noCar = std::numeric_limits<unsigned>::max();
+
+// Zobrist hash of a state, kept up to date by MoveCar
+typedef std::uint64_t StateHash;
+
 typedef std::deque<std::tuple<unsigned, Direction, unsigned>> PossibleMoveVector; // Iterate through this
 typedef PossibleMoveVector ReverseMoveVector; // for rolling back the map
 
+// Order SolveRushHourRec tries the moves in
+// naturalOrder - as CalculatePossibleMoves generates them
+// blockerOrder - moves that clear the main car's exit lane or advance the main car first
+enum MoveOrdering { naturalOrder, blockerOrder };
+
+// What the depth first search remembers of the states it went through
+// exactVisited  - the states on the path and the closed list
+// filterVisited - a Bloom filter of every state it went into (see RushHourSolver::Filter)
+enum VisitedSet { exactVisited, filterVisited };
+
+// Compile time switches of the recursive search. Every combination is instantiated and
+// RushHourSolver::SelectSearch picks one from the run time settings, so a switch that is
+// off costs nothing in the search that runs.
+template<bool ClosedListOpt, bool PartialOrderOpt, MoveOrdering Ordering, bool Tracing,
+         bool Logging, bool HashCheck, VisitedSet Visited>
+struct SearchPolicy {
+	static bool const closedList = ClosedListOpt;      // prune the states the closed list has failed with
+	static bool const partialOrder = PartialOrderOpt;  // one order of commuting moves, no car moved twice in a row
+	static MoveOrdering const ordering = Ordering;
+	static bool const tracing = Tracing;               // every move goes to the TraceWriter
+	static bool const logging = Logging;               // every node and move is printed to std::cout
+	static bool const hashCheck = HashCheck;           // the hash is recomputed after every move and compared
+	static VisitedSet const visited = Visited;         // the filter goes without the closed list and the ordering
+};
+
+// States stored back to back in one arena, a byte per car (its position along its line, see
+// RushHourSolver::Key), with a value of 32 bits each. Found through an open addressing table
+// of indices into the arena, keyed by the hash. The states are still compared in full, so a
+// collision can't prune anything. The slots are stamped with an epoch and the ones of an
+// older epoch are empty, so Clear is O(1) and keeps the memory for the next search.
+class StateTable {
+public:
+	static size_t const noState = static_cast<size_t>(-1);
+
+private:
+	struct Slot {
+		StateHash hash;
+		std::uint32_t state;            // index into the arena
+		std::uint32_t epoch;            // the slot is empty unless it is the current one
+	};
+
+	size_t stride = 0;                  // bytes per state
+	size_t count = 0;                   // states in the arena
+	std::vector<char> arena = std::vector<char>();
+	std::vector<StateHash> hashes = std::vector<StateHash>();   // per state, to move it in the table
+	std::vector<std::uint32_t> values = std::vector<std::uint32_t>();
+	std::vector<Slot> slots = std::vector<Slot>();              // size is a power of 2
+	std::uint32_t epoch = 1;
+
+	/**
+	 * @brief Slot of a state, or the empty slot it would go to
+	 * @param hash Hash of the state
+	 * @param state Packed state
+	 * @return Index into slots
+	 */
+	size_t Probe(StateHash hash, char const * state) const;
+
+	/**
+	 * @brief Doubles the slots and puts every state back
+	 */
+	void Grow();
+
+	/**
+	 * @brief Puts the states of the arena back into empty slots
+	 */
+	void Reindex();
+
+public:
+	/**
+	 * @brief Setter for the size of the states, empties the table
+	 * @param bytes Bytes per state, the number of cars
+	 */
+	void Stride(size_t bytes) { stride = bytes; Clear(); }
+
+	/**
+	 * @brief Finds a state
+	 * @param hash Hash of the state
+	 * @param state Packed state
+	 * @return Its index, noState if it is not there
+	 */
+	size_t Find(StateHash hash, char const * state) const;
+
+	/**
+	 * @brief Adds a state that is not in the table
+	 * @param hash Hash of the state
+	 * @param state Packed state
+	 * @param value Value of the state
+	 * @return Its index
+	 */
+	size_t Insert(StateHash hash, char const * state, std::uint32_t value = 0);
+
+	/**
+	 * @brief Sets the value of a state, adds it if it is not in the table
+	 * @param hash Hash of the state
+	 * @param state Packed state
+	 * @param value Value of the state
+	 */
+	void Set(StateHash hash, char const * state, std::uint32_t value);
+
+	/**
+	 * @brief Removes a state, the last one of the arena takes its index
+	 * @param hash Hash of the state
+	 * @param state Packed state, has to be in the table
+	 */
+	void Erase(StateHash hash, char const * state);
+
+	/**
+	 * @brief Removes the states whose value remove returns true for. Rebuilds the arena and
+	 *        gives back the memory it doesn't need any more.
+	 * @param remove Called with the value of every state, in the order of the arena
+	 */
+	template<typename Remove>
+	void RemoveIf(Remove remove) {
+		size_t kept = 0;
+		for (size_t index = 0; index < count; ++index) {
+			if (remove(values[index]))
+				continue;
+			std::copy(arena.begin() + static_cast<std::ptrdiff_t>(index * stride), arena.begin() + static_cast<std::ptrdiff_t>((index + 1) * stride),
+			          arena.begin() + static_cast<std::ptrdiff_t>(kept * stride));
+			hashes[kept] = hashes[index];
+			values[kept] = values[index];
+			++kept;
+		}
+		count = kept;
+		arena.resize(count * stride);
+		hashes.resize(count);
+		values.resize(count);
+		arena.shrink_to_fit();
+		hashes.shrink_to_fit();
+		values.shrink_to_fit();
+		size_t size = 16;
+		while (size * 3 < count * 4)
+			size *= 2;
+		std::vector<Slot>(size, Slot{ 0, 0, 0 }).swap(slots);
+		epoch = 1;
+		Reindex();
+	}
+
+	std::uint32_t Value(size_t index) const { return values[index]; }
+
+	size_t Size() const { return count; }
+
+	bool Empty() const { return count == 0; }
+
+	/**
+	 * @brief Empties the table in O(1), the memory is kept
+	 */
+	void Clear();
+
+	/**
+	 * @brief Empties the table and gives its memory back
+	 */
+	void Release();
+
+	/**
+	 * @brief Bytes the table holds on to
+	 * @return Number of bytes
+	 */
+	size_t Bytes() const;
+
+	/**
+	 * @brief Bytes a state takes in a table at its fullest
+	 * @return Number of bytes
+	 */
+	size_t BytesPerState() const { return stride + sizeof(StateHash) + sizeof(std::uint32_t) + sizeof(Slot) * 4 / 3; }
+};
+
+typedef StateTable StateHistory; // to prevent infinite loops
+
 // CLOSED LIST OPT
-struct ClosedListSearchNode {
-	CarLocations carLocation;
-	size_t solSize;
+// Transposition table: the value of a state is the moves left it can't reach the goal within.
+// Stays valid between the iterations of iterative deepening.
+typedef StateTable ClosedList; // to cancel out some branches
+
+// Bloom filter over state hashes, a compact visited set for the searches that are after any
+// solution. A few bits per state instead of a closed list entry, but a state that was never
+// searched is taken for a searched one at the false positive rate and its subtree is lost.
+// A search that has to be optimal can't use it.
+class VisitedFilter {
+private:
+	std::vector<std::uint64_t> bits = std::vector<std::uint64_t>();
+	std::uint64_t bitCount = 0;
+	unsigned hashes = 0;            // bits set per state
+	size_t states = 0;              // states taken in
+	size_t setBits = 0;
+	double falsePrunes = 0;         // expected new states rejected so far
+
+public:
+	VisitedFilter() {}
+
+	/**
+	 * @brief Constructor of the class, sizes the filter for the rate at the given states.
+	 *        Past them the rate goes up, FalsePositiveRate tells by how much.
+	 * @param expectedStates States the filter is sized for
+	 * @param falsePositiveRate Chance that a new state is taken for a visited one, in (0, 1)
+	 */
+	VisitedFilter(size_t expectedStates, double falsePositiveRate);
+
+	/**
+	 * @brief Whether the filter has any bits, a default constructed one doesn't
+	 * @return Enabled or not
+	 */
+	bool Enabled() const { return !bits.empty(); }
 
-	bool operator==(CarLocations const & rhs) const;
+	/**
+	 * @brief Adds a state unless it looks visited already
+	 * @param hash Zobrist hash of the state
+	 * @return false if every bit of the state was set, it is pruned then
+	 */
+	bool Insert(StateHash hash);
+
+	/**
+	 * @brief Getter for the number of states taken in
+	 * @return Number of states
+	 */
+	size_t States() const { return states; }
+
+	/**
+	 * @brief Size of the bit array
+	 * @return Number of bytes
+	 */
+	size_t Bytes() const { return bits.size() * sizeof(std::uint64_t); }
+
+	/**
+	 * @brief Chance that the next new state is taken for a visited one, from the bits set so far
+	 * @return False positive rate
+	 */
+	double FalsePositiveRate() const;
 
-	ClosedListSearchNode(CarLocations location, size_t size);
+	/**
+	 * @brief Expected number of times a new state was pruned, the sum of the false positive
+	 *        rates the states were taken in at
+	 * @return Estimated false prunes
+	 */
+	double FalsePrunes() const { return falsePrunes; }
+};
+
+// Rectangle of cells a car covers while making a move, both ends included
+struct SweptCells {
+	unsigned firstRow;
+	unsigned firstColumn;
+	unsigned lastRow;
+	unsigned lastColumn;
+
+	SweptCells(CarInfo const & info, Direction d, unsigned positions)
+	: firstRow(info.row), firstColumn(info.column),
+	  lastRow(info.orientation == vertical ? info.row + info.size - 1 : info.row),
+	  lastColumn(info.orientation == horisontal ? info.column + info.size - 1 : info.column)
+	{
+		switch (d) {
+			case up:    firstRow -= positions; break;
+			case left:  firstColumn -= positions; break;
+			case down:  lastRow += positions; break;
+			case right: lastColumn += positions; break;
+			default: break;
+		}
+	}
+
+	bool Overlaps(SweptCells const & rhs) const {
+		return firstRow <= rhs.lastRow && rhs.firstRow <= lastRow && firstColumn <= rhs.lastColumn && rhs.firstColumn <= lastColumn;
+	}
+};
+
+// Where the move generation of a node is, NextMove picks up from here. Lives in the
+// search frame, so a node only looks at the cells of the moves it gets to try.
+struct MoveCursor {
+	size_t next = 0;                // car being looked at, index into the move order of the cars
+	unsigned phase = 0;             // 0 - towards right/down, 1 - towards left/up, 2 - car done
+	unsigned positions = 0;         // positions of the last move looked at in this phase
+	unsigned previousCar = noCar;   // car of the move that led to the node
+	unsigned previousId = 0;        // its number in the file, 0 for none
+	SweptCells previousCells = SweptCells(CarInfo(), undefined, 0); // cells that move swept
 };
 
-typedef std::list<ClosedListSearchNode> ClosedList; // to cancel out some branches
+// Plain copy of a parking lot for the tools that don't need a whole solver (validator etc.)
+struct ParkingLotBoard {
+	unsigned height = 0;
+	unsigned width = 0;
+	unsigned car = 0;                        // car to be navigated
+	Direction exitDirection = undefined;
+	std::vector<unsigned> cells = std::vector<unsigned>(); // row major, 0 is an empty cell
+};
 
 /*
  * Rush Hour solving class that contains all the data needed. Called by the global functions
  */
 class RushHourSolver {
+	friend class RushHourDomain;
+	friend class RushHourSession;
+	friend class OptimalSolutions;
+	friend class ShardedSearch;
+	friend class SolverBenchmark;
 private:
 	ParkingLotMap parkingLot = ParkingLotMap();      // parking lot 
 	unsigned height = 0;            // size of parking lot
 	unsigned width = 0;            // size of parking lot
 	Direction exitDirection = undefined;    // exit direction
-	unsigned car = 0;            // car to be navigated
+	unsigned car = 0;            // car to be navigated, its number in the file (index 0 in the solver)
+	std::vector<unsigned> carIds = std::vector<unsigned>();    // car numbers of the file by index
+	std::vector<unsigned> moveOrder = std::vector<unsigned>(); // indices in the order the cars are found in the file, moves are generated in it
 	std::string filename = std::string();// filename for data
 
 	unsigned currentLevel = 1;
 	unsigned maxIterationLevel = std::numeric_limits<unsigned>::max();
 	unsigned maxLevel = std::numeric_limits<unsigned>::max();
 
+	// Checkpointed frontier: paths to the nodes the last iteration cut off at maxIterationLevel.
+	// The next iteration resumes from them instead of searching the shallow tree again.
+	std::vector<MoveList> frontier = std::vector<MoveList>();
+	std::vector<MoveList> checkpoint = std::vector<MoveList>(); // frontier of the previous iteration
+	bool recordFrontier = false;
+	size_t frontierLimit = 1 << 20; // past this many nodes the next iteration starts from the root
+
 	// Data for storing vars
 	StateHistory stateHistory = StateHistory();
 	ClosedList closedList = ClosedList();
 	CarLocations currentCarLocations = CarLocations();
+	std::string key = std::string(); // current state packed for the state tables, see Key
+
+	// Zobrist hashing: one random key per (car index, cell), state hash is the xor of the cars' keys
+	std::vector<StateHash> zobristKeys = std::vector<StateHash>();
+	StateHash stateHash = 0;
+
+	TraceWriter * trace = nullptr;  // records explored moves when set
+	PhaseTimeline * timeline = nullptr; // records the phases when set
+	MoveOrdering moveOrdering = naturalOrder;
+	bool closedListOpt = true;      // see SearchPolicy
+	bool partialOrderOpt = true;
+	bool logging = false;
+	bool hashCheck = false;
+
+	// Search limits and stats
+	unsigned long long nodes = 0;   // Search calls
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+	CancellationToken cancelToken;  // cancelled by another thread to stop the search
+	bool stopped = false;           // deadline passed or cancelled, the search unwinds
+	bool cancelled = false;
+	bool unsolvable = false;        // the component was explored without a goal, searches stop right away
+	ComponentReport component = ComponentReport(); // last ExploreComponent
+	bool componentExplored = false; // the recursion explores the component once, past componentCheckNodes
+	unsigned long long solveNodes = 0; // nodes when the solve started, the component check counts from there
+	CarLocations solveRoot = CarLocations(); // state the solve started from, the component is explored from it
+	ProgressCallback progress;
+	std::chrono::steady_clock::duration progressInterval = std::chrono::milliseconds(250);
+	std::chrono::steady_clock::time_point searchStart;
+	std::chrono::steady_clock::time_point lastProgress;
+	unsigned long long lastProgressNodes = 0;
+
+	// Memory accounting
+	size_t memoryBudget = 0;        // 0 for no limit
+	MemoryUsage memory = MemoryUsage();
+	bool closedListEnabled = true;  // turned off when evicting is not enough to stay in the budget
+	bool overBudget = false;        // set by the graph search, it falls back to iterative deepening
+	MoveCost moveCost = MoveCost(); // prices of SolveCheapest
+	VisitedFilter filter = VisitedFilter(); // visited set of SolveRushHourRec instead of the path and the closed list when enabled
 
 	// Helper methods
+	/**
+	 * @brief Finds the cars of the loaded parking lot, numbers them densely with the main car
+	 *        first and writes the indices into the parking lot.
+	 */
+	void IndexCars();
+
+	typedef bool (RushHourSolver::*SearchFunction)(MoveList & solution);
+
+	/**
+	 * @brief Recursive search behind SolveRushHourRec, moves are by car index
+	 * @param solution Solution to be filled
+	 * @return Whether it is solved or not
+	 */
+	template<typename Policy>
+	bool Search ( MoveList & solution );
+
+	/**
+	 * @brief Instantiation of Search for the switches, the ordering and the trace writer
+	 *        that are set, or of SearchFiltered when the Bloom filter is enabled and allowed
+	 * @param filtered Whether the Bloom filter may be used, not for a bounded search
+	 * @return Search to run
+	 */
+	SearchFunction SelectSearch(bool filtered) const;
+
+	/**
+	 * @brief Puts the search of every combination of the SelectSearch bits from Bits down
+	 *        to 0 into the table, the false_type overload ends the recursion
+	 * @param searches Table indexed by the bits
+	 */
+	template<unsigned Bits>
+	static void FillSearches(SearchFunction * searches, std::true_type);
+	template<unsigned Bits>
+	static void FillSearches(SearchFunction *, std::false_type) {}
+
+	/**
+	 * @brief Search of a policy with the exact visited set
+	 * @return Search<Policy>
+	 */
+	template<typename Policy>
+	static SearchFunction SearchOf(std::integral_constant<VisitedSet, exactVisited> visited);
+
+	/**
+	 * @brief Search of a policy with the Bloom filter
+	 * @return SearchFiltered<Policy>
+	 */
+	template<typename Policy>
+	static SearchFunction SearchOf(std::integral_constant<VisitedSet, filterVisited> visited);
+
+	/**
+	 * @brief Depth first search behind SolveRushHourRec when the Bloom filter is enabled. Goes
+	 *        into every state the filter lets through once, in the order the moves are
+	 *        generated, with its own stack. Moves are by car index.
+	 * @param solution Solution to be filled
+	 * @return Whether it is solved or not
+	 */
+	template<typename Policy>
+	bool SearchFiltered ( MoveList & solution );
+
+	/**
+	 * @brief Throws if the hash kept up to date by MoveCar is not the one of the state
+	 *        (the hashCheck of SearchPolicy)
+	 */
+	void CheckHash() const;
+
+	/**
+	 * @brief Translates a move to the car numbers of the file
+	 * @param move Move by car index
+	 * @return Same move by car number
+	 */
+	std::tuple<unsigned, Direction, unsigned> CarIdMove(std::tuple<unsigned, Direction, unsigned> const & move) const;
+
     /**
      * @brief Member function to calculate all the possible moves and their reverses in each iteration.
      *
      * @param possibleMoves The move list to be applied on the current state.
      * @param reverseMoves The move list to be applied on the resulting state to return to the current state.
+     * @param previous Move that led to the current state; moves it makes redundant are left out. nullptr for all moves.
      */
-	void CalculatePossibleMoves(PossibleMoveVector & possibleMoves, ReverseMoveVector & reverseMoves);
+	void CalculatePossibleMoves(PossibleMoveVector & possibleMoves, ReverseMoveVector & reverseMoves,
+	                            std::tuple<unsigned, Direction, unsigned> const * previous = nullptr);
+
+	/**
+	 * @brief Starts the move generation of the current state.
+	 * @param cursor Cursor to be reset
+	 * @param previous Move that led to the current state; moves it makes redundant are left out. nullptr for all moves.
+	 */
+	void StartMoves(MoveCursor & cursor, std::tuple<unsigned, Direction, unsigned> const * previous) const;
+
+	/**
+	 * @brief Generates the next move of the current state, in the order of CalculatePossibleMoves.
+	 *        The state has to be the one the cursor was started on.
+	 * @param cursor Where the generation is, advanced past the move
+	 * @param move Next move
+	 * @return false when there are no more moves
+	 */
+	bool NextMove(MoveCursor & cursor, std::tuple<unsigned, Direction, unsigned> & move) const;
+
+	/**
+	 * @brief Every move of the current state at once, what StartMoves and NextMove give
+	 * @param moves The moves are appended to it, by car index
+	 * @param previous Move that led to the current state, see StartMoves
+	 */
+	void ListMoves(MoveList & moves, std::tuple<unsigned, Direction, unsigned> const * previous = nullptr) const;
+
+	/**
+	 * @brief Finds the current state among stored states indexed by their hash
+	 * @param index Positions in states by the hash of the state
+	 * @param states Stored states, their car locations are in locations
+	 * @return Position of the current state in states, static_cast<size_t>(-1) if it is
+	 *         not there
+	 */
+	template<typename Node>
+	size_t FindState(std::unordered_multimap<StateHash, size_t> const & index, std::vector<Node> const & states) const
+	{
+		typedef std::unordered_multimap<StateHash, size_t>::const_iterator Iterator;
+		std::pair<Iterator, Iterator> range = index.equal_range(stateHash);
+		for (Iterator iter = range.first; iter != range.second; ++iter) {
+			if (states[iter->second].locations == currentCarLocations)
+				return iter->second;
+		}
+		return static_cast<size_t>(-1);
+	}
+
+	/**
+	 * @brief Step of Search: makes the move, searches from there unless the state is
+	 *        already on the path, and takes the move back unless a solution is found.
+	 * @param move Move to be tried
+	 * @param solution Solution to be filled
+	 * @return Whether it is solved or not
+	 */
+	template<typename Policy>
+	bool TryMove(std::tuple<unsigned, Direction, unsigned> const & move, MoveList & solution);
 
 	// Saves bunch of if checks
 	/**
@@ -129,6 +719,135 @@ private:
 	 */
 	unsigned CalculateVerticalCarSize(unsigned x, unsigned y, unsigned carID);
 
+	/**
+	 * @brief Sorts the moves so the one with the best blocker score is tried first.
+	 * @param possibleMoves Moves from CalculatePossibleMoves, reordered in place
+	 * @param reverseMoves Reverses of the moves, kept in step with possibleMoves
+	 */
+	void OrderMoves(PossibleMoveVector & possibleMoves, ReverseMoveVector & reverseMoves);
+
+	/**
+	 * @brief Applies given move to the map and the current car states, the move of the
+	 *        searches. Doesn't check that the car exists.
+	 * @param move The move to be applied, by car index (see CarId)
+	 */
+	void MoveCar(std::tuple< unsigned, Direction, unsigned > move);
+
+	/**
+	 * @brief Replaces the current state with the given one (map, car locations and hash)
+	 *        and forgets what was proved about the old one (see ForgetComponent)
+	 * @param locations Car locations of the new state
+	 */
+	void LoadState(CarLocations const & locations);
+
+	/**
+	 * @brief LoadState for the states of a search, keeps Unsolvable and the component report
+	 * @param locations Car locations of the new state
+	 */
+	void PlaceState(CarLocations const & locations);
+
+	/**
+	 * @brief Clears Unsolvable, the stop it caused and the component report
+	 */
+	void ForgetComponent();
+
+	/**
+	 * @brief Starts a solve from the current state: forgets the component of the last one
+	 *        and counts the nodes of the component check from here
+	 */
+	void BeginSolve();
+
+	/**
+	 * @brief Reads the clock and the cancel token, sets stopped if the search has to give up.
+	 *        Reports progress when the interval has passed. Called every few thousand nodes.
+	 * @param depth Depth of the state being searched
+	 * @param closedListSize Size of the closed list (or visited states) of the search
+	 */
+	void CheckLimits(unsigned depth, size_t closedListSize);
+
+	/**
+	 * @brief Estimated bytes of a stored state (car locations)
+	 * @return Bytes of one CarLocations copy
+	 */
+	size_t StateBytes() const;
+
+	/**
+	 * @brief Updates the memory counters of the recursion and gives things up while it is
+	 *        over the budget: the frontier checkpoints, then closed list entries with the
+	 *        fewest moves left, then the closed list.
+	 * @param solution Path being searched
+	 */
+	void AccountRecursion(MoveList const & solution);
+
+	/**
+	 * @brief Memory accounting of SearchFiltered, with the stats of the filter
+	 * @param frames Frames allocated for the path
+	 * @param solution Path being searched
+	 */
+	void AccountFilter(size_t frames, MoveList const & solution);
+
+	/**
+	 * @brief Evicts closed list entries, the ones with the fewest moves left first
+	 * @param bytes Bytes to free at least
+	 */
+	void EvictClosedList(size_t bytes);
+
+	/**
+	 * @brief Shared loop of the best-first and breadth-first searches.
+	 * @param solution Solution to be filled
+	 * @param breadthFirst Order the open list by depth instead of by blocker score
+	 * @return Whether it is solved or not
+	 */
+	bool SolveGraphSearch ( MoveList & solution, bool breadthFirst );
+
+	/**
+	 * @brief Runs iterative deepening after the graph search went over the memory budget.
+	 * @param solution Solution to be filled
+	 * @return Whether it is solved or not, false if the budget was not the problem
+	 */
+	bool FallBack ( MoveList & solution );
+
+	/**
+	 * @brief Applies a path from the current state and runs Search from its end.
+	 *        Everything is rolled back unless a solution is found.
+	 * @param path Moves from the current state
+	 * @param solution Solution to be filled, starts with path
+	 * @param search Search to run, see SelectSearch
+	 * @return Whether it is solved or not
+	 */
+	bool ResumeFrom ( MoveList const & path, MoveList & solution, SearchFunction search );
+
+	/**
+	 * @brief ExploreComponent with the visited states packed into a std::uint64_t (when
+	 *        every car position fits) or a std::string (one byte per car)
+	 * @param positionBits Bits a car position takes in a std::uint64_t
+	 * @return Same as ExploreComponent
+	 */
+	template<typename Packed>
+	ComponentReport ExploreComponent(unsigned positionBits);
+
+	/**
+	 * @brief SolveCheapest with the states packed the same way as ExploreComponent
+	 * @param solution Solution to be filled, by car index
+	 * @param positionBits Bits a car position takes in a std::uint64_t
+	 * @return Whether it is solved or not
+	 */
+	template<typename Packed>
+	bool SolveCheapest(MoveList & solution, unsigned positionBits);
+
+	/**
+	 * @brief Packs the current state for stateHistory and closedList: the position of every
+	 *        car along its line, a byte each
+	 * @return Packed state, valid until the next call
+	 */
+	char const * Key();
+
+	/**
+	 * @brief Computes the hash of the current state from scratch.
+	 * @return Xor of the keys of all the cars
+	 */
+	StateHash ComputeStateHash() const;
+
 	// debugging
 	/**
 	 * @brief Used for debugging to print all the moves given to it
@@ -173,11 +892,18 @@ public:
 	 */
 	Direction const& Dir() const { return exitDirection; }
 
+	/**
+	 * @brief Copies the current parking lot into a flat board
+	 * @return Board in row major order
+	 */
+	ParkingLotBoard Board() const;
+
 	/**
 	 * @brief Constructor of the class
 	 * @param filename The name of the file of the map data
+	 * @param timeline Timeline to record the parsing and the later phases into, nullptr for none
 	 */
-	RushHourSolver(std::string const&  filename);
+	RushHourSolver(std::string const&  filename, PhaseTimeline * timeline = nullptr);
 
 	/**
 	 * @brief Destructor of the class
@@ -186,7 +912,8 @@ public:
 
 	/**
 	 * @brief Applies given move to the map and the current car states.
-	 * @param move The move to be applied.
+	 * @param move The move to be applied, by the car number of the file. A car that
+	 *        isn't on the board isn't moved.
 	 */
 	void makeMove(std::tuple< unsigned, Direction, unsigned > move);
 
@@ -212,16 +939,154 @@ public:
 	// My rather uncool stuff
 	/**
 	 * @brief Recursive method for all global rush hour methods
-	 * @param solution Solution to be filled
+	 * @param solution Solution to be filled, by car number
 	 * @return Whether it is solved or not
 	 */
 	bool SolveRushHourRec ( MoveList & solution );
 
 	/**
-	 * @brief Initializes car locations.
+	 * @brief Greedy best-first search on the blocker score, finds a solution, usually a short one.
+	 *        Falls back to iterative deepening over the memory budget.
+	 * @param solution Solution to be filled
+	 * @return Whether it is solved or not
+	 */
+	bool SolveBestFirst ( MoveList & solution );
+
+	/**
+	 * @brief Breadth-first search with a visited set, finds the shortest solution.
+	 *        Falls back to iterative deepening over the memory budget.
+	 * @param solution Solution to be filled
+	 * @return Whether it is solved or not
+	 */
+	bool SolveBreadthFirst ( MoveList & solution );
+
+	/**
+	 * @brief Cheap estimate of how far the current state is from the goal:
+	 *        2 per car in the main car's exit lane plus 1 per cell between the main car and the exit.
+	 * @return Blocker score, 0 when solved
+	 */
+	unsigned BlockerScore() const;
+
+	/**
+	 * @brief Estimate that never overestimates: 1 for the main car plus 1 per car in its exit lane.
+	 * @return Lower bound of the moves left, 0 when solved
+	 */
+	unsigned LowerBound() const;
+
+	/**
+	 * @brief Breadth-first search over the states reachable from the current one, visited
+	 *        states are kept packed, only the position of each car. Stops at the first solved state, so
+	 *        a board without a solution is the only one that gets explored in full. Then
+	 *        Unsolvable is set and the searches give up right away.
+	 *        Honors the deadline, the cancellation token and the memory budget. Its states
+	 *        are neither in Nodes nor in the total of Memory, they have a counter of their own.
+	 * @return Whether it is solvable, whether it was explored in full, the states visited
+	 *         and the moves to the goal
+	 */
+	ComponentReport ExploreComponent();
+
+	/**
+	 * @brief Whether the position of every car fits into one std::uint64_t (see Pack)
+	 * @return Packable or not
+	 */
+	bool Packable() const;
+
+	/**
+	 * @brief Packs the current state: the position of every car along its line, in as few
+	 *        bits as the parking lot needs. Only for Packable boards.
+	 * @return Packed state
+	 */
+	std::uint64_t Pack() const;
+
+	/**
+	 * @brief Loads a state made by Pack
+	 * @param packed Packed state of the same level
+	 */
+	void Unpack(std::uint64_t packed);
+
+	/**
+	 * @brief Setter for the move ordering of SolveRushHourRec
+	 * @param ordering New ordering
+	 */
+	void Ordering(MoveOrdering ordering) { moveOrdering = ordering; }
+
+	/**
+	 * @brief Setter for the closed list of SolveRushHourRec and iterative deepening (see
+	 *        SearchPolicy). On by default.
+	 * @param enabled Whether states are pruned by the closed list
+	 */
+	void ClosedListOpt(bool enabled) { closedListOpt = enabled; }
+
+	/**
+	 * @brief Setter for searching one order of the commuting moves only (see SearchPolicy).
+	 *        On by default.
+	 * @param enabled Whether the redundant orders are left out
+	 */
+	void PartialOrderOpt(bool enabled) { partialOrderOpt = enabled; }
+
+	/**
+	 * @brief Setter for printing every node and move of SolveRushHourRec and iterative
+	 *        deepening to std::cout (see SearchPolicy). Off by default.
+	 * @param enabled Whether the searches print
+	 */
+	void Logging(bool enabled) { logging = enabled; }
+
+	/**
+	 * @brief Setter for recomputing the hash after every move of SolveRushHourRec and
+	 *        iterative deepening and throwing when it is not the kept one (see SearchPolicy).
+	 *        Off by default.
+	 * @param enabled Whether the hash is checked
+	 */
+	void HashCheck(bool enabled) { hashCheck = enabled; }
+
+	/**
+	 * @brief Iterative deepening over SolveRushHourRec, finds the shortest solution.
+	 *        The closed list is kept between the iterations and every iteration after the
+	 *        first resumes from the frontier of the previous one.
+	 * @param solution Solution to be filled
+	 * @return Whether it is solved or not (false only if timed out)
+	 */
+	bool SolveIterativeDeepening ( MoveList & solution );
+
+	/**
+	 * @brief Dijkstra's search on the prices of MoveCost, finds the cheapest solution. The
+	 *        prices are small integers, so the queue is a ring of buckets, one per price up to
+	 *        the most expensive move. Proves the board unsolvable when the queue runs dry.
+	 * @param solution Solution to be filled
+	 * @return Whether it is solved or not
+	 */
+	bool SolveCheapest ( MoveList & solution );
+
+	/**
+	 * @brief Setter for the prices of SolveCheapest
+	 * @param cost Price of the moves
+	 */
+	void Cost(MoveCost const & cost) { moveCost = cost; }
+
+	/**
+	 * @brief Getter for the prices of SolveCheapest
+	 * @return Price of the moves
+	 */
+	MoveCost const & Cost() const { return moveCost; }
+
+	/**
+	 * @brief Initializes the search state of the car locations (hashing, history).
 	 */
 	void InitCarLocations();
 
+	/**
+	 * @brief Number of a car in the level file
+	 * @param index Index of the car in the solver
+	 * @return Car number
+	 */
+	unsigned CarId(unsigned index) const { return carIds[index]; }
+
+	/**
+	 * @brief Translates moves by car index to the car numbers of the file
+	 * @param moves Moves to be translated in place
+	 */
+	void ToCarIds(MoveList & moves) const;
+
 	/**
 	 * @brief For clearing closed list between each iteration.
 	 */
@@ -233,6 +1098,155 @@ public:
 	 */
 	void MaxIteration(unsigned iter);
 
+	/**
+	 * @brief Setter for the frontier size limit of iterative deepening
+	 * @param limit Max number of checkpointed nodes, 0 turns checkpointing off
+	 */
+	void FrontierLimit(size_t limit) { frontierLimit = limit; }
+
+	/**
+	 * @brief Setter for the trace writer. Starts the trace with the current board.
+	 * @param writer Writer to record the explored moves into, nullptr to stop tracing
+	 */
+	void Trace(TraceWriter * writer);
+
+	/**
+	 * @brief Setter for the phase timeline
+	 * @param phases Timeline to record the phases into, nullptr to stop recording
+	 */
+	void Timeline(PhaseTimeline * phases) { timeline = phases; }
+
+	/**
+	 * @brief Setter for the deadline. The search gives up once it passes.
+	 * @param time Point in time after which the search stops
+	 */
+	void Deadline(std::chrono::steady_clock::time_point time) { deadline = time; cancelled = false; stopped = unsolvable; }
+
+	/**
+	 * @brief Getter for the deadline
+	 * @return Point in time after which the search stops
+	 */
+	std::chrono::steady_clock::time_point Deadline() const { return deadline; }
+
+	/**
+	 * @brief Getter for the cancellation token
+	 * @return Token the search watches
+	 */
+	CancellationToken const & Cancellation() const { return cancelToken; }
+
+	/**
+	 * @brief Setter for the cancellation token. The search gives up soon after it is cancelled.
+	 * @param token Token shared with the caller
+	 */
+	void Cancellation(CancellationToken const & token) { cancelToken = token; cancelled = false; stopped = unsolvable; }
+
+	/**
+	 * @brief Setter for the progress callback
+	 * @param callback Called from the search at most once per interval, empty for none
+	 * @param interval Min time between two calls, must be positive when there is a callback
+	 */
+	void Progress(ProgressCallback const & callback, std::chrono::milliseconds interval);
+
+	/**
+	 * @brief Sets the token, deadline and progress callback at once
+	 * @param options Options of the next search
+	 */
+	void Options(SolveOptions const & options);
+
+	/**
+	 * @brief Whether the last search stopped because of the deadline
+	 * @return Timed out or not
+	 */
+	bool TimedOut() const { return stopped && !cancelled && !unsolvable; }
+
+	/**
+	 * @brief Whether the board was proved to have no solution (see ExploreComponent)
+	 * @return Unsolvable or not
+	 */
+	bool Unsolvable() const { return unsolvable; }
+
+	/**
+	 * @brief Getter for what the last ExploreComponent found out, the component size among others.
+	 *        The check of a solve explores from the state it started in, so goalDepth is
+	 *        then the length of a shortest solution. Cleared when a solve starts.
+	 * @return Report of the last exploration
+	 */
+	ComponentReport const & Component() const { return component; }
+
+	/**
+	 * @brief Whether the last search stopped because of the cancellation token
+	 * @return Cancelled or not
+	 */
+	bool Cancelled() const { return cancelled; }
+
+	/**
+	 * @brief Getter for the hash of the current state
+	 * @return Zobrist hash
+	 */
+	StateHash Hash() const { return stateHash; }
+
+	/**
+	 * @brief Getter for the number of searched nodes
+	 * @return Number of nodes
+	 */
+	unsigned long long Nodes() const { return nodes; }
+
+	/**
+	 * @brief Setter for the memory budget. Iterative deepening evicts from its closed list to
+	 *        stay in it, BFS and best-first fall back to iterative deepening.
+	 * @param bytes Bytes the search structures may use, 0 for no limit
+	 */
+	void MemoryBudget(size_t bytes) { memoryBudget = bytes; }
+
+	/**
+	 * @brief Getter for the memory accounting
+	 * @return Current and peak bytes per structure
+	 */
+	MemoryUsage const & Memory() const { return memory; }
+
+	/**
+	 * @brief Setter for the visited set of SolveRushHourRec. With a Bloom filter every state is
+	 *        searched at most once and kept in a few bits, a new state is pruned now and then
+	 *        (see MemoryUsage). The moves are tried in the order they are generated then.
+	 *        Iterative deepening keeps its exact closed list.
+	 * @param expectedStates States the filter is sized for, 0 for the exact closed list
+	 * @param falsePositiveRate Chance that a new state is taken for a visited one
+	 */
+	void Filter(size_t expectedStates, double falsePositiveRate = 0.001);
+
+};
+
+/*
+ * Rush hour for the drivers in search.h. Works on the solver's current state. Moves are
+ * by car index, RushHourSolver::ToCarIds translates a path.
+ */
+class RushHourDomain {
+public:
+	typedef std::tuple<unsigned, Direction, unsigned> Move;
+	typedef CarLocations State;
+
+private:
+	RushHourSolver & solver;
+	bool partialOrder;
+	MoveList applied = MoveList();           // for leaving out redundant moves
+
+public:
+	/**
+	 * @brief Constructor of the class, a solve starts from the solver's current state
+	 * @param solver Initialized solver (after InitCarLocations)
+	 * @param partialOrder Leave out the moves the last move makes redundant (see CalculatePossibleMoves)
+	 */
+	explicit RushHourDomain(RushHourSolver & solver, bool partialOrder = true) : solver(solver), partialOrder(partialOrder) { solver.BeginSolve(); }
+
+	void Moves(std::vector<Move> & moves);
+	void Apply(Move const & move) { solver.MoveCar(move); applied.push_back(move); }
+	void Undo(Move const & move);
+	std::uint64_t Hash() const { return solver.stateHash; }
+	State Save() const { return solver.currentCarLocations; }
+	bool Equals(State const & state) const { return solver.currentCarLocations == state; }
+	void Load(State const & state) { solver.PlaceState(state); applied.clear(); }
+	bool IsGoal() const { return solver.IsSolved(); }
+	unsigned Heuristic() const { return solver.LowerBound(); }
 };
 
 
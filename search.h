@@ -0,0 +1,376 @@
+/*!
+* \file search.h
+* \author Egemen Koku
+* \date 19 Oct 2026
+* \brief Search drivers shared by the puzzles (header only)
+*
+* \copyright Digipen Institute of Technology
+*
+* A domain is the puzzle the drivers search. It has to provide
+*   typedef ... Move;                         a move
+*   typedef ... State;                        an exact copy of the state
+*   void Moves(std::vector<Move> & moves);    appends the moves of the current state, first one is tried first
+*   void Apply(Move const & move);
+*   void Undo(Move const & move);             undoes the last applied move
+*   std::uint64_t Hash() const;               hash of the current state
+*   State Save() const;
+*   bool Equals(State const & state) const;   whether the current state is state
+*   void Load(State const & state);           replaces the current state, forgets the applied moves
+*   bool IsGoal() const;
+*   unsigned Heuristic() const;               lower bound of the moves left, only IDAStar uses it
+* A domain may leave moves out of Moves that the moves applied before it make redundant
+* (undoing the last move, moving the same piece twice ...).
+*/
+
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <vector>
+#include <deque>
+#include <limits>
+#include <functional>
+#include <unordered_map>
+#include <cstdint>
+
+template<typename Domain>
+class GenericSearch {
+public:
+	typedef typename Domain::Move Move;
+	typedef typename Domain::State State;
+	typedef std::vector<Move> Path;
+
+private:
+	// state with how many moves it had left when it was fully searched without a solution
+	struct ClosedNode {
+		State state;
+		unsigned remaining;
+	};
+
+	Domain & domain;
+	std::vector< std::vector<Move> > moves;                  // one buffer per depth, reused
+	std::unordered_multimap<std::uint64_t, State> history;   // states on the current path
+	std::unordered_multimap<std::uint64_t, ClosedNode> closed;
+	std::unordered_multimap<std::uint64_t, State> frontier;  // cut off by the bound of IDAStar and not expanded in its iteration
+	bool transpositions = true;
+	std::function<bool()> stop;                              // asked every few thousand nodes
+	bool stopped = false;
+	bool cutOff = false;                                     // DepthLimited reached the bound below a state that isn't the goal
+	unsigned long long nodes = 0;
+
+	// Finds the exact state among the ones sharing its hash
+	template<typename StateMap, typename Match>
+	static typename StateMap::iterator Find(StateMap & states, std::uint64_t hash, Match match)
+	{
+		std::pair<typename StateMap::iterator, typename StateMap::iterator> range = states.equal_range(hash);
+		for (typename StateMap::iterator iter = range.first; iter != range.second; ++iter) {
+			if (match(iter->second))
+				return iter;
+		}
+		return states.end();
+	}
+
+	bool Visit()
+	{
+		if ((++nodes & 4095) == 0 && stop && stop())
+			stopped = true;
+		return !stopped;
+	}
+
+	// deeper calls may grow the buffers, so they are always indexed, never referenced
+	void Generate(size_t depth)
+	{
+		if (moves.size() <= depth)
+			moves.resize(depth + 1);
+		moves[depth].clear();
+		domain.Moves(moves[depth]);
+	}
+
+	// depth limited DFS, states on the path are skipped and fully searched states are
+	// remembered with the depth they had left
+	bool DepthLimited(Path & path, unsigned remaining)
+	{
+		if (!Visit())
+			return false;
+		if (domain.IsGoal())
+			return true;
+
+		Domain const & current = domain;
+		auto same = [&current](ClosedNode const & node) { return current.Equals(node.state); };
+		auto onPath = [&current](State const & state) { return current.Equals(state); };
+		std::uint64_t hash = domain.Hash();
+		if (transpositions) {
+			typename std::unordered_multimap<std::uint64_t, ClosedNode>::iterator iter = Find(closed, hash, same);
+			if (iter != closed.end()) {
+				if (remaining > iter->second.remaining)
+					closed.erase(iter);
+				else
+					return false;
+			}
+		}
+
+		if (remaining == 0)
+			cutOff = true;
+		else {
+			size_t depth = path.size();
+			Generate(depth);
+			for (size_t i = 0; i < moves[depth].size() && !stopped; ++i) {
+				Move move = moves[depth][i];
+				domain.Apply(move);
+				std::uint64_t childHash = domain.Hash();
+				if (Find(history, childHash, onPath) == history.end()) {
+					typename std::unordered_multimap<std::uint64_t, State>::iterator entry = history.insert(std::make_pair(childHash, domain.Save()));
+					path.push_back(move);
+					if (DepthLimited(path, remaining - 1))
+						return true;
+					path.pop_back();
+					history.erase(entry);
+				}
+				domain.Undo(move);
+			}
+		}
+
+		if (transpositions && !stopped)
+			closed.insert(std::make_pair(hash, ClosedNode{ domain.Save(), remaining }));
+		return false;
+	}
+
+	// f limited DFS, next gets the smallest f that was cut off. The closed list only
+	// lives for one iteration: an entry from an earlier bound could hide cut offs
+	// smaller than the ones it caused back then. With the closed list the states that
+	// were cut off and never expanded are kept in frontier.
+	bool CostLimited(Path & path, unsigned bound, unsigned & next)
+	{
+		if (!Visit())
+			return false;
+		Domain const & current = domain;
+		auto same = [&current](ClosedNode const & node) { return current.Equals(node.state); };
+		auto cut = [&current](State const & state) { return current.Equals(state); };
+		std::uint64_t hash = domain.Hash();
+		unsigned g = static_cast<unsigned>(path.size());
+		unsigned f = g + domain.Heuristic();
+		if (f > bound) {
+			if (f < next)
+				next = f;
+			if (transpositions && Find(closed, hash, same) == closed.end() && Find(frontier, hash, cut) == frontier.end())
+				frontier.insert(std::make_pair(hash, domain.Save()));
+			return false;
+		}
+		if (domain.IsGoal())
+			return true;
+
+		unsigned remaining = bound - g;
+		if (transpositions) {
+			typename std::unordered_multimap<std::uint64_t, ClosedNode>::iterator iter = Find(closed, hash, same);
+			if (iter != closed.end()) {
+				if (remaining > iter->second.remaining)
+					closed.erase(iter);
+				else
+					return false;
+			}
+			typename std::unordered_multimap<std::uint64_t, State>::iterator entry = Find(frontier, hash, cut);
+			if (entry != frontier.end())
+				frontier.erase(entry);
+		}
+
+		size_t depth = path.size();
+		Generate(depth);
+		for (size_t i = 0; i < moves[depth].size() && !stopped; ++i) {
+			Move move = moves[depth][i];
+			domain.Apply(move);
+			path.push_back(move);
+			if (CostLimited(path, bound, next))
+				return true;
+			path.pop_back();
+			domain.Undo(move);
+		}
+
+		if (transpositions && !stopped)
+			closed.insert(std::make_pair(hash, ClosedNode{ domain.Save(), remaining }));
+		return false;
+	}
+
+public:
+	/**
+	 * @brief Constructor of the class
+	 * @param domain Puzzle to be searched, starting from its current state
+	 */
+	explicit GenericSearch(Domain & domain) : domain(domain) {}
+
+	/**
+	 * @brief Setter for the stop check
+	 * @param check Asked every 4096 nodes, the search gives up once it returns true
+	 */
+	void Stop(std::function<bool()> const & check) { stop = check; }
+
+	/**
+	 * @brief Setter for the closed list of DepthFirst, IterativeDeepening and IDAStar
+	 * @param enabled Remember fully searched states or not
+	 */
+	void Transpositions(bool enabled) { transpositions = enabled; }
+
+	/**
+	 * @brief Whether the last search gave up because of the stop check
+	 * @return Stopped or not
+	 */
+	bool Stopped() const { return stopped; }
+
+	/**
+	 * @brief Getter for the number of searched nodes
+	 * @return Number of nodes
+	 */
+	unsigned long long Nodes() const { return nodes; }
+
+	/**
+	 * @brief Depth first search. On success the domain is left in the goal state.
+	 * @param path Moves from the start to the goal
+	 * @param maxDepth Longest path searched
+	 * @return Whether it is solved or not
+	 */
+	bool DepthFirst(Path & path, unsigned maxDepth = std::numeric_limits<unsigned>::max())
+	{
+		stopped = false;
+		history.clear();
+		closed.clear();
+		history.insert(std::make_pair(domain.Hash(), domain.Save()));
+		return DepthLimited(path, maxDepth);
+	}
+
+	/**
+	 * @brief Iterative deepening, the closed list is kept between iterations. The path is
+	 *        a shortest one. On success the domain is left in the goal state. Ends without
+	 *        a solution after an iteration that the bound cut nothing off in or, with the
+	 *        closed list, that reached no state for the first time: the deeper ones would
+	 *        search the same states.
+	 * @param path Moves from the start to the goal
+	 * @param maxDepth Longest path searched
+	 * @return Whether it is solved or not
+	 */
+	bool IterativeDeepening(Path & path, unsigned maxDepth = std::numeric_limits<unsigned>::max())
+	{
+		stopped = false;
+		closed.clear();
+		size_t known = 0;                                    // states in the closed list after the last iteration
+		for (unsigned depth = 0; depth <= maxDepth && !stopped; ++depth) {
+			history.clear();
+			history.insert(std::make_pair(domain.Hash(), domain.Save()));
+			cutOff = false;
+			if (DepthLimited(path, depth))
+				return true;
+			if (!cutOff || (transpositions && closed.size() == known))
+				return false;
+			known = closed.size();
+		}
+		return false;
+	}
+
+	/**
+	 * @brief Breadth first search. The path is a shortest one. The domain is put back in
+	 *        the start state.
+	 * @param path Moves from the start to the goal
+	 * @return Whether it is solved or not
+	 */
+	bool BreadthFirst(Path & path)
+	{
+		// every generated state once, parents point back into the same vector
+		struct Node {
+			State state;
+			size_t parent;
+			Move move;
+		};
+		stopped = false;
+		std::vector<Node> states;
+		std::unordered_multimap<std::uint64_t, size_t> seen;
+		std::deque<size_t> open;
+
+		State start = domain.Save();
+		states.push_back(Node{ start, 0, Move() });
+		seen.insert(std::make_pair(domain.Hash(), 0));
+		open.push_back(0);
+
+		size_t goal = 0;
+		bool found = domain.IsGoal();
+		Domain const & now = domain;
+		auto same = [&states, &now](size_t node) { return now.Equals(states[node].state); };
+		while (!open.empty() && !found && Visit()) {
+			size_t current = open.front();
+			open.pop_front();
+			domain.Load(states[current].state);
+
+			Generate(0);
+			std::vector<Move> const & children = moves[0];
+			for (size_t i = 0; i < children.size() && !found; ++i) {
+				domain.Apply(children[i]);
+				if (Find(seen, domain.Hash(), same) == seen.end()) {
+					states.push_back(Node{ domain.Save(), current, children[i] });
+					seen.insert(std::make_pair(domain.Hash(), states.size() - 1));
+					if (domain.IsGoal()) {
+						found = true;
+						goal = states.size() - 1;
+					}
+					else {
+						open.push_back(states.size() - 1);
+					}
+				}
+				domain.Undo(children[i]);
+			}
+		}
+
+		if (found) {
+			Path reversed;
+			for (size_t node = goal; node != 0; node = states[node].parent) {
+				reversed.push_back(states[node].move);
+			}
+			path.assign(reversed.rbegin(), reversed.rend());
+		}
+		domain.Load(start);
+		return found;
+	}
+
+	/**
+	 * @brief IDA*, the path is a shortest one if the heuristic never overestimates.
+	 *        On success the domain is left in the goal state. With the closed list it
+	 *        ends without a solution after an iteration that expanded every state it
+	 *        reached, which is then every state there is. Without it a puzzle with
+	 *        cycles and no solution is searched up to maxBound or the stop check.
+	 * @param path Moves from the start to the goal
+	 * @param maxBound Largest f searched
+	 * @return Whether it is solved or not
+	 */
+	bool IDAStar(Path & path, unsigned maxBound = std::numeric_limits<unsigned>::max())
+	{
+		stopped = false;
+		unsigned bound = domain.Heuristic();
+		while (bound <= maxBound && !stopped) {
+			unsigned next = std::numeric_limits<unsigned>::max();
+			closed.clear();
+			frontier.clear();
+			if (CostLimited(path, bound, next))
+				return true;
+			// nothing was cut off, or nothing that wasn't expanded anyway
+			if (next == std::numeric_limits<unsigned>::max() || (transpositions && !stopped && frontier.empty()))
+				return false;
+			bound = next;
+		}
+		return false;
+	}
+
+	/**
+	 * @brief Replays a path from the current state and checks that it ends in the goal.
+	 *        The domain is put back in the state it was in.
+	 * @param path Moves to be checked, they have to be legal
+	 * @return Whether the path solves the puzzle
+	 */
+	bool Check(Path const & path)
+	{
+		for (Move const & move : path) {
+			domain.Apply(move);
+		}
+		bool solved = domain.IsGoal();
+		for (typename Path::const_reverse_iterator iter = path.rbegin(); iter != path.rend(); ++iter) {
+			domain.Undo(*iter);
+		}
+		return solved;
+	}
+};
+
+#endif
@@ -0,0 +1,213 @@
+/*!
+* \file session.cpp
+* \author Egemen Koku
+* \date 19 Oct 2026
+* \brief Impl of @b session.cpp
+*
+* \copyright Digipen Institute of Technology
+*
+*/
+
+#include "session.h"
+
+RushHourSession::RushHourSession(std::string const & filename, size_t maxStates, std::chrono::milliseconds localSearchTime)
+: solver(filename), maxStates(maxStates), localSearchTime(localSearchTime)
+{
+	solver.InitCarLocations();
+	for (unsigned i = 0; i < solver.carIds.size(); ++i) {
+		unsigned id = solver.carIds[i];
+		if (carIndex.size() <= id)
+			carIndex.resize(id + 1, noCar);
+		carIndex[id] = i;
+	}
+	Explore();
+}
+
+void RushHourSession::Explore()
+{
+	CarLocations start = solver.currentCarLocations;
+	states.push_back(Node{ start, noSolution });
+	index.insert(std::make_pair(solver.stateHash, 0));
+
+	// every reachable state, the solved ones are where the distances start from
+	std::vector<size_t> open;
+	for (size_t next = 0; next < states.size(); ++next) {
+		solver.LoadState(states[next].locations);
+		if (solver.IsSolved()) {
+			states[next].distance = 0;
+			open.push_back(next);
+		}
+		GenerateMoves();
+		for (Move const & move : moves) {
+			solver.MoveCar(move);
+			if (Find() == noState) {
+				if (states.size() == maxStates) {
+					// too many to keep, positions get solved when they come up
+					states.clear();
+					index.clear();
+					solver.LoadState(start);
+					return;
+				}
+				states.push_back(Node{ solver.currentCarLocations, noSolution });
+				index.insert(std::make_pair(solver.stateHash, states.size() - 1));
+			}
+			solver.MoveCar(ReverseMove(move));
+		}
+	}
+
+	// every move can be taken back, so searching forward from the solved states gives
+	// the distances to them. The states it never gets to have no solution.
+	for (size_t next = 0; next < open.size(); ++next) {
+		unsigned distance = states[open[next]].distance + 1;
+		solver.LoadState(states[open[next]].locations);
+		GenerateMoves();
+		for (Move const & move : moves) {
+			solver.MoveCar(move);
+			size_t node = Find();
+			if (states[node].distance == noSolution) {
+				states[node].distance = distance;
+				open.push_back(node);
+			}
+			solver.MoveCar(ReverseMove(move));
+		}
+	}
+
+	solver.LoadState(start);
+	explored = true;
+}
+
+bool RushHourSession::SolveLocally()
+{
+	++localSearches;
+	RushHourSolver local(solver);
+	local.stateHistory.Clear();
+	local.stateHistory.Insert(local.stateHash, local.Key());
+	local.Deadline(std::chrono::steady_clock::now() + localSearchTime);
+	MoveList solution;
+	if (!local.SolveIterativeDeepening(solution)) {
+		// proved to have no solution, unlike running out of time, is kept like a distance
+		if (!local.Unsolvable())
+			return false;
+		if (states.size() >= maxStates) {
+			states.clear();
+			index.clear();
+		}
+		if (states.size() < maxStates) {
+			states.push_back(Node{ solver.currentCarLocations, noSolution });
+			index.insert(std::make_pair(solver.stateHash, states.size() - 1));
+		}
+		return true;
+	}
+
+	// a shortest solution is made of shortest solutions of the states along it. The
+	// cache starts over when they don't fit, the states of this one are the ones asked for
+	if (states.size() + solution.size() >= maxStates) {
+		states.clear();
+		index.clear();
+	}
+	unsigned distance = static_cast<unsigned>(solution.size());
+	MoveList applied;
+	for (size_t i = 0; ; ++i) {
+		if (states.size() < maxStates && Find() == noState) {
+			states.push_back(Node{ solver.currentCarLocations, distance });
+			index.insert(std::make_pair(solver.stateHash, states.size() - 1));
+		}
+		if (i == solution.size())
+			break;
+		Move move(carIndex[std::get<0>(solution[i])], std::get<1>(solution[i]), std::get<2>(solution[i]));
+		solver.MoveCar(move);
+		applied.push_back(move);
+		--distance;
+	}
+	for (MoveList::const_reverse_iterator iter = applied.rbegin(); iter != applied.rend(); ++iter) {
+		solver.MoveCar(ReverseMove(*iter));
+	}
+	return true;
+}
+
+size_t RushHourSession::Lookup()
+{
+	size_t node = Find();
+	if (node != noState) {
+		++cacheHits;
+		return node;
+	}
+	if (explored || !SolveLocally())
+		return noState;
+	return Find();
+}
+
+bool RushHourSession::Play(Move const & move)
+{
+	unsigned id = std::get<0>(move);
+	if (id >= carIndex.size() || carIndex[id] == noCar)
+		return false;
+	Move indexed(carIndex[id], std::get<1>(move), std::get<2>(move));
+	GenerateMoves();
+	for (Move const & legal : moves) {
+		if (legal == indexed) {
+			solver.MoveCar(indexed);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool RushHourSession::Closer(unsigned distance, Move & move)
+{
+	// a neighbour one move closer is the next move of a shortest solution
+	GenerateMoves();
+	for (Move const & next : moves) {
+		solver.MoveCar(next);
+		size_t neighbour = Find();
+		solver.MoveCar(ReverseMove(next));
+		if (neighbour != noState && states[neighbour].distance == distance - 1) {
+			move = Move(solver.CarId(std::get<0>(next)), std::get<1>(next), std::get<2>(next));
+			return true;
+		}
+	}
+	return false;
+}
+
+bool RushHourSession::Hint(Move & move)
+{
+	size_t node = Lookup();
+	if (node == noState || states[node].distance == 0 || states[node].distance == noSolution)
+		return false;
+
+	unsigned distance = states[node].distance;
+	if (Closer(distance, move))
+		return true;
+	// the cache filled up before the rest of the solution from here was kept
+	return !explored && SolveLocally() && Closer(distance, move);
+}
+
+unsigned RushHourSession::Distance()
+{
+	size_t node = Lookup();
+	return node == noState ? noSolution : states[node].distance;
+}
+
+bool RushHourSession::Solution(MoveList & solution)
+{
+	solution.clear();
+	MoveList applied;
+	Move move;
+	bool solved = true;
+	while (!solver.IsSolved()) {
+		if (!Hint(move)) {
+			solved = false;
+			break;
+		}
+		Move indexed(carIndex[std::get<0>(move)], std::get<1>(move), std::get<2>(move));
+		solver.MoveCar(indexed);
+		applied.push_back(indexed);
+		solution.push_back(move);
+	}
+	for (MoveList::const_reverse_iterator iter = applied.rbegin(); iter != applied.rend(); ++iter) {
+		solver.MoveCar(ReverseMove(*iter));
+	}
+	if (!solved)
+		solution.clear();
+	return solved;
+}
@@ -0,0 +1,166 @@
+/*!
+* \file session.h
+* \author Egemen Koku
+* \date 19 Oct 2026
+* \brief Interface of @b session.cpp - hints for a game in progress
+*
+* \copyright Digipen Institute of Technology
+*
+*/
+
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <vector>
+#include <chrono>
+#include "rushhour.h"
+
+/*
+ * Follows a game move by move and hands out the next move of a shortest solution.
+ * The states reachable from the start are explored once, with the distance of every
+ * one of them to the goal, so a hint after a player move is a lookup. When there are
+ * more states than the session keeps, positions are solved with a bounded iterative
+ * deepening instead and the states along the solutions found are remembered.
+ * Moves are by car number, the same as the solutions of SolveRushHour.
+ */
+class RushHourSession {
+public:
+	typedef std::tuple<unsigned, Direction, unsigned> Move;
+
+private:
+	// explored state and how many moves it is from the goal
+	struct Node {
+		CarLocations locations;
+		unsigned distance;
+	};
+
+	RushHourSolver solver;                   // holds the position of the game
+	std::vector<unsigned> carIndex = std::vector<unsigned>(); // solver index by car number
+	std::vector<Node> states = std::vector<Node>();
+	std::unordered_multimap<StateHash, size_t> index = std::unordered_multimap<StateHash, size_t>();
+	std::vector<Move> moves = std::vector<Move>(); // moves of the current state, by car index
+	size_t maxStates;
+	std::chrono::milliseconds localSearchTime;
+	bool explored = false;                   // every reachable state is in states
+	unsigned long long cacheHits = 0;
+	unsigned long long localSearches = 0;
+
+	/**
+	 * @brief Explores the states reachable from the current one, then the distances by a
+	 *        breadth-first search back from the solved states. Keeps nothing if there are
+	 *        more than maxStates of them.
+	 */
+	void Explore();
+
+	/**
+	 * @brief Finds the current state among the explored ones
+	 * @return Its index in states, noState if it is not there
+	 */
+	size_t Find() const { return solver.FindState(index, states); }
+
+	/**
+	 * @brief Finds the current state, solving it locally if it is not known yet
+	 * @return Its index in states, noState if the local search ran out of time
+	 */
+	size_t Lookup();
+
+	/**
+	 * @brief Iterative deepening from the current state with localSearchTime to go.
+	 *        Remembers every state along the solution with its distance, at most
+	 *        maxStates of them: a full cache is dropped first. A state proved to have
+	 *        no solution is remembered with noSolution.
+	 * @return Whether the state was solved or proved to have no solution
+	 */
+	bool SolveLocally();
+
+	/**
+	 * @brief Fills moves with every move of the current state
+	 */
+	void GenerateMoves() { moves.clear(); solver.ListMoves(moves); }
+
+	/**
+	 * @brief Finds a move to a remembered neighbour one move closer to the goal
+	 * @param distance Distance of the current state
+	 * @param move Move to be filled, by car number
+	 * @return Whether there is such a neighbour
+	 */
+	bool Closer(unsigned distance, Move & move);
+
+public:
+	static size_t const noState = static_cast<size_t>(-1);
+	static unsigned const noSolution = std::numeric_limits<unsigned>::max();
+
+	/**
+	 * @brief Constructor of the class, explores the level
+	 * @param filename The name of the file of the map data
+	 * @param maxStates Most states the session keeps, past it positions are solved one by one
+	 * @param localSearchTime Time a position may take to be solved when it was not explored
+	 */
+	explicit RushHourSession(std::string const & filename, size_t maxStates = 1 << 20,
+	                         std::chrono::milliseconds localSearchTime = std::chrono::milliseconds(1000));
+
+	/**
+	 * @brief Applies a player move
+	 * @param move Move by car number
+	 * @return false if the move is not legal, nothing changes then
+	 */
+	bool Play(Move const & move);
+
+	/**
+	 * @brief Next move of a shortest solution from the current position
+	 * @param move Move to be filled, by car number
+	 * @return false if solved, there is no solution or the local search ran out of time
+	 */
+	bool Hint(Move & move);
+
+	/**
+	 * @brief Moves left to the goal from the current position
+	 * @return Number of moves, noSolution if there is none or the local search ran out of time
+	 */
+	unsigned Distance();
+
+	/**
+	 * @brief Shortest solution from the current position, the position stays the same
+	 * @param solution Solution to be filled, by car number
+	 * @return false if there is no solution or the local search ran out of time
+	 */
+	bool Solution(MoveList & solution);
+
+	/**
+	 * @brief Whether the current position is solved
+	 * @return Solved or not
+	 */
+	bool IsSolved() const { return solver.IsSolved(); }
+
+	/**
+	 * @brief Copies the current position into a flat board
+	 * @return Board in row major order
+	 */
+	ParkingLotBoard Board() const { return solver.Board(); }
+
+	/**
+	 * @brief Whether every reachable state was explored, so hints never search
+	 * @return Explored or not
+	 */
+	bool Explored() const { return explored; }
+
+	/**
+	 * @brief Getter for the number of remembered states
+	 * @return Number of states
+	 */
+	size_t States() const { return states.size(); }
+
+	/**
+	 * @brief Getter for the number of positions answered from the remembered states
+	 * @return Number of cache hits
+	 */
+	unsigned long long CacheHits() const { return cacheHits; }
+
+	/**
+	 * @brief Getter for the number of positions that had to be solved
+	 * @return Number of local searches
+	 */
+	unsigned long long LocalSearches() const { return localSearches; }
+};
+
+#endif
@@ -0,0 +1,399 @@
+/*!
+* \file shard.cpp
+* \author Egemen Koku
+* \date 19 Oct 2026
+* \brief Impl of @b shard.cpp
+*
+* \copyright Digipen Institute of Technology
+*
+*/
+
+#include "shard.h"
+#include <algorithm>
+#include <unordered_map>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
+
+namespace {
+	std::uint32_t const recordSolved = 1;
+	std::uint32_t const recordEndOfLayer = 2;
+	size_t const readChunk = 1 << 16;
+
+	bool WriteAll(int fd, void const * buffer, size_t size)
+	{
+		char const * bytes = static_cast<char const *>(buffer);
+		while (size) {
+			ssize_t written = write(fd, bytes, size);
+			if (written < 0 && errno == EINTR)
+				continue;
+			if (written <= 0)
+				return false;
+			bytes += written;
+			size -= static_cast<size_t>(written);
+		}
+		return true;
+	}
+
+	bool ReadAll(int fd, void * buffer, size_t size)
+	{
+		char * bytes = static_cast<char *>(buffer);
+		while (size) {
+			ssize_t got = read(fd, bytes, size);
+			if (got < 0 && errno == EINTR)
+				continue;
+			if (got <= 0)
+				return false;
+			bytes += got;
+			size -= static_cast<size_t>(got);
+		}
+		return true;
+	}
+
+	std::uint32_t EncodeMove(std::tuple<unsigned, Direction, unsigned> const & move)
+	{
+		return std::get<0>(move) << 16 | static_cast<std::uint32_t>(std::get<1>(move)) << 8 | std::get<2>(move);
+	}
+
+	std::tuple<unsigned, Direction, unsigned> DecodeMove(std::uint64_t move)
+	{
+		return std::make_tuple(static_cast<unsigned>(move >> 16), static_cast<Direction>((move >> 8) & 0xff), static_cast<unsigned>(move & 0xff));
+	}
+}
+
+ShardPipes::~ShardPipes()
+{
+	Stop();
+}
+
+void ShardPipes::CloseAllBut(std::vector<int> const & keep)
+{
+	for (std::vector<int> * ends : { &data, &control }) {
+		for (int & fd : *ends) {
+			if (fd >= 0 && std::find(keep.begin(), keep.end(), fd) == keep.end()) {
+				close(fd);
+				fd = -1;
+			}
+		}
+	}
+}
+
+void ShardPipes::Start(std::function<void(unsigned)> const & worker)
+{
+	data.assign(2 * shards * shards, -1);
+	control.assign(4 * shards, -1);
+	for (unsigned from = 0; from < shards; ++from) {
+		for (unsigned to = 0; to < shards; ++to) {
+			if (from == to)
+				continue;
+			if (pipe(&DataEnd(from, to, 0)) != 0)
+				throw "Cannot create the pipes of the shards";
+			// a worker keeps reading while it writes, see Exchange
+			fcntl(DataEnd(from, to, 1), F_SETFL, fcntl(DataEnd(from, to, 1), F_GETFL) | O_NONBLOCK);
+		}
+		if (pipe(&ControlEnd(from, true, 0)) != 0 || pipe(&ControlEnd(from, false, 0)) != 0)
+			throw "Cannot create the pipes of the shards";
+	}
+
+	for (unsigned shard = 0; shard < shards; ++shard) {
+		pid_t pid = fork();
+		if (pid < 0)
+			throw "Cannot start the shard workers";
+		if (pid == 0) {
+			self = shard;
+			std::vector<int> keep{ ControlEnd(shard, true, 0), ControlEnd(shard, false, 1) };
+			for (unsigned peer = 0; peer < shards; ++peer) {
+				if (peer != shard) {
+					keep.push_back(DataEnd(peer, shard, 0));
+					keep.push_back(DataEnd(shard, peer, 1));
+				}
+			}
+			CloseAllBut(keep);
+			workers.clear();
+			int status = 0;
+			try {
+				worker(shard);
+			}
+			catch (...) {
+				status = 1;
+			}
+			_exit(status);
+		}
+		workers.push_back(pid);
+	}
+
+	// the coordinator only talks over its ends of the control pipes
+	std::vector<int> keep;
+	for (unsigned shard = 0; shard < shards; ++shard) {
+		keep.push_back(ControlEnd(shard, true, 1));
+		keep.push_back(ControlEnd(shard, false, 0));
+	}
+	CloseAllBut(keep);
+}
+
+void ShardPipes::Exchange(std::vector<std::vector<ShardRecord>> & outgoing, std::vector<ShardRecord> & incoming)
+{
+	incoming.clear();
+	incoming.swap(outgoing[self]);
+
+	// every peer gets its records and an end of layer marker
+	struct Peer {
+		std::vector<char> send;
+		size_t sent;
+		std::vector<char> received;
+		bool done;
+	};
+	std::vector<Peer> peers(shards);
+	ShardRecord const end{ 0, 0, 0, recordEndOfLayer };
+	for (unsigned peer = 0; peer < shards; ++peer) {
+		if (peer == self)
+			continue;
+		std::vector<ShardRecord> & records = outgoing[peer];
+		records.push_back(end);
+		char const * bytes = reinterpret_cast<char const *>(records.data());
+		peers[peer].send.assign(bytes, bytes + records.size() * sizeof(ShardRecord));
+		peers[peer].sent = 0;
+		peers[peer].done = false;
+		records.clear();
+	}
+
+	std::vector<pollfd> fds;
+	std::vector<unsigned> owners;
+	std::vector<char> chunk(readChunk);
+	for (;;) {
+		fds.clear();
+		owners.clear();
+		for (unsigned peer = 0; peer < shards; ++peer) {
+			if (peer == self)
+				continue;
+			if (peers[peer].sent < peers[peer].send.size()) {
+				fds.push_back(pollfd{ DataEnd(self, peer, 1), POLLOUT, 0 });
+				owners.push_back(peer);
+			}
+			if (!peers[peer].done) {
+				fds.push_back(pollfd{ DataEnd(peer, self, 0), POLLIN, 0 });
+				owners.push_back(peer);
+			}
+		}
+		if (fds.empty())
+			break;
+		if (poll(fds.data(), fds.size(), -1) < 0) {
+			if (errno == EINTR)
+				continue;
+			throw "Cannot poll the pipes of the shards";
+		}
+
+		for (size_t i = 0; i < fds.size(); ++i) {
+			Peer & peer = peers[owners[i]];
+			if (fds[i].events == POLLOUT && fds[i].revents) {
+				ssize_t written = write(fds[i].fd, peer.send.data() + peer.sent, peer.send.size() - peer.sent);
+				if (written < 0 && errno != EAGAIN && errno != EINTR)
+					throw "A shard worker exited";
+				if (written > 0)
+					peer.sent += static_cast<size_t>(written);
+			}
+			else if (fds[i].events == POLLIN && fds[i].revents) {
+				ssize_t got = read(fds[i].fd, chunk.data(), chunk.size());
+				if (got < 0 && (errno == EAGAIN || errno == EINTR))
+					continue;
+				if (got <= 0)
+					throw "A shard worker exited";
+				peer.received.insert(peer.received.end(), chunk.begin(), chunk.begin() + got);
+
+				size_t whole = peer.received.size() / sizeof(ShardRecord);
+				size_t first = incoming.size();
+				incoming.resize(first + whole);
+				std::memcpy(&incoming[first], peer.received.data(), whole * sizeof(ShardRecord));
+				peer.received.erase(peer.received.begin(), peer.received.begin() + static_cast<std::ptrdiff_t>(whole * sizeof(ShardRecord)));
+				// the peer sends nothing after its marker until the next layer
+				if (whole && incoming.back().flags & recordEndOfLayer) {
+					incoming.pop_back();
+					peer.done = true;
+				}
+			}
+		}
+	}
+}
+
+bool ShardPipes::ReceiveControl(ShardMessage & message)
+{
+	return ReadAll(ControlEnd(self, true, 0), &message, sizeof(message));
+}
+
+bool ShardPipes::SendControl(ShardMessage const & message)
+{
+	return WriteAll(ControlEnd(self, false, 1), &message, sizeof(message));
+}
+
+bool ShardPipes::Send(unsigned shard, ShardMessage const & message)
+{
+	return WriteAll(ControlEnd(shard, true, 1), &message, sizeof(message));
+}
+
+bool ShardPipes::Receive(unsigned shard, ShardMessage & message)
+{
+	return ReadAll(ControlEnd(shard, false, 0), &message, sizeof(message));
+}
+
+void ShardPipes::Stop()
+{
+	// closing the control pipes ends the workers that are still waiting on them
+	CloseAllBut(std::vector<int>());
+	for (pid_t pid : workers) {
+		int status;
+		while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+		}
+	}
+	workers.clear();
+}
+
+unsigned ShardedSearch::Owner(std::uint64_t packed) const
+{
+	// the low bits of a packed state are the position of the main car only
+	return static_cast<unsigned>(((packed * 0x9E3779B97F4A7C15ULL) >> 32) % transport.Shards());
+}
+
+void ShardedSearch::Work(unsigned shard)
+{
+	unsigned shards = transport.Shards();
+	std::unordered_map<std::uint64_t, Parent> visited;
+	std::vector<std::uint64_t> frontier;
+	std::vector<std::vector<ShardRecord>> outgoing(shards);
+	std::vector<ShardRecord> incoming;
+
+	std::uint64_t start = solver.Pack();
+	if (Owner(start) == shard) {
+		visited.insert(std::make_pair(start, Parent{ start, 0, 0 }));
+		frontier.push_back(start);
+	}
+
+	ShardMessage message;
+	std::uint32_t depth = 0;
+	while (transport.ReceiveControl(message)) {
+		if (message.kind == expandLayer) {
+			MoveCursor cursor;
+			std::tuple<unsigned, Direction, unsigned> move;
+			for (std::uint64_t state : frontier) {
+				solver.Unpack(state);
+				solver.StartMoves(cursor, nullptr);
+				while (solver.NextMove(cursor, move)) {
+					solver.MoveCar(move);
+					std::uint64_t child = solver.Pack();
+					outgoing[Owner(child)].push_back(ShardRecord{ child, state, EncodeMove(move), solver.IsSolved() ? recordSolved : 0 });
+					solver.MoveCar(ReverseMove(move));
+				}
+			}
+			transport.Exchange(outgoing, incoming);
+
+			// the smallest parent of a state wins, so every number of shards gives the same path
+			++depth;
+			frontier.clear();
+			ShardMessage done{ layerDone, 0, 0, 0 };
+			for (ShardRecord const & record : incoming) {
+				std::pair<std::unordered_map<std::uint64_t, Parent>::iterator, bool> inserted
+					= visited.insert(std::make_pair(record.state, Parent{ record.parent, record.move, depth }));
+				if (inserted.second) {
+					frontier.push_back(record.state);
+					if (record.flags & recordSolved && (!done.flag || record.state < done.state)) {
+						done.flag = 1;
+						done.state = record.state;
+					}
+				}
+				else {
+					Parent & parent = inserted.first->second;
+					if (parent.depth == depth && std::make_pair(record.parent, record.move) < std::make_pair(parent.state, parent.move)) {
+						parent.state = record.parent;
+						parent.move = record.move;
+					}
+				}
+			}
+			done.value = frontier.size();
+			if (!transport.SendControl(done))
+				return;
+		}
+		else if (message.kind == parentQuery) {
+			std::unordered_map<std::uint64_t, Parent>::const_iterator found = visited.find(message.state);
+			ShardMessage reply{ parentReply, 0, 0, 0 };
+			if (found != visited.end()) {
+				reply.flag = 1;
+				reply.state = found->second.state;
+				reply.value = found->second.move;
+			}
+			if (!transport.SendControl(reply))
+				return;
+		}
+		else if (message.kind == stopWorker) {
+			transport.SendControl(ShardMessage{ workerStats, 0, 0, visited.size() });
+			return;
+		}
+	}
+}
+
+bool ShardedSearch::Solve(MoveList & solution)
+{
+	solution.clear();
+	layers = 0;
+	states = 1;
+	stopped = false;
+	if (!solver.Packable())
+		throw "Board too big for the sharded search";
+	if (solver.IsSolved())
+		return true;
+
+	unsigned shards = transport.Shards();
+	transport.Start([this](unsigned shard) { Work(shard); });
+
+	ShardMessage message;
+	bool found = false;
+	std::uint64_t goal = 0;
+	for (;;) {
+		solver.CheckLimits(layers, states);
+		if (solver.stopped) {
+			stopped = true;
+			break;
+		}
+		for (unsigned shard = 0; shard < shards; ++shard) {
+			if (!transport.Send(shard, ShardMessage{ expandLayer, 0, 0, 0 }))
+				throw "A shard worker exited";
+		}
+		size_t frontier = 0;
+		for (unsigned shard = 0; shard < shards; ++shard) {
+			if (!transport.Receive(shard, message) || message.kind != layerDone)
+				throw "A shard worker exited";
+			frontier += message.value;
+			if (message.flag && (!found || message.state < goal)) {
+				found = true;
+				goal = message.state;
+			}
+		}
+		++layers;
+		states += frontier;
+		// no new state anywhere: every reachable one was seen, none of them solved
+		if (found || frontier == 0)
+			break;
+	}
+
+	if (found) {
+		std::uint64_t start = solver.Pack();
+		for (std::uint64_t state = goal; state != start; ) {
+			if (!transport.Send(Owner(state), ShardMessage{ parentQuery, 0, state, 0 })
+			    || !transport.Receive(Owner(state), message) || !message.flag)
+				throw "A shard worker lost a state";
+			solution.push_back(DecodeMove(message.value));
+			state = message.state;
+		}
+		std::reverse(solution.begin(), solution.end());
+		solver.ToCarIds(solution);
+	}
+
+	states = 0;
+	for (unsigned shard = 0; shard < shards; ++shard) {
+		if (transport.Send(shard, ShardMessage{ stopWorker, 0, 0, 0 }) && transport.Receive(shard, message) && message.kind == workerStats)
+			states += message.value;
+	}
+	transport.Stop();
+	return found;
+}
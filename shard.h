@@ -0,0 +1,230 @@
+/*!
+* \file shard.h
+* \author Egemen Koku
+* \date 19 Oct 2026
+* \brief Interface of @b shard.cpp - breadth-first search split over worker processes (POSIX only)
+*
+* \copyright Digipen Institute of Technology
+*
+* Every worker owns the states whose packed form hashes into its shard: it keeps their
+* parents and expands them. The workers expand a layer together, the children go to their
+* owners in batches and the layer is over for a worker once every other one has told it
+* so. The coordinator (the calling process) starts the layers, stops after the first one
+* with a solved state and follows the parents back from it, asking their owners.
+*/
+
+#ifndef SHARD_H
+#define SHARD_H
+
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <sys/types.h>
+#include "rushhour.h"
+
+// Child state on its way to its owner, records are sent as they are in memory
+struct ShardRecord {
+	std::uint64_t state;
+	std::uint64_t parent;
+	std::uint32_t move;                      // car index << 16 | direction << 8 | positions
+	std::uint32_t flags;                     // recordSolved, recordEndOfLayer
+};
+
+// Message between the coordinator and a worker
+struct ShardMessage {
+	std::uint32_t kind;                      // see ShardMessageKind
+	std::uint32_t flag;
+	std::uint64_t state;
+	std::uint64_t value;
+};
+
+enum ShardMessageKind {
+	expandLayer,    // coordinator: expand the frontier
+	layerDone,      // worker: flag - found a solved state (state), value - size of the new frontier
+	parentQuery,    // coordinator: parent of state
+	parentReply,    // worker: flag - known, state - parent, value - move
+	stopWorker,     // coordinator: done
+	workerStats     // worker: value - states it owns
+};
+
+/*
+ * Links between the coordinator and the workers. The search only goes through this, so
+ * the pipes of ShardPipes can be swapped for sockets to workers on other machines.
+ */
+class ShardTransport {
+public:
+	virtual ~ShardTransport() {}
+
+	/**
+	 * @brief Number of workers
+	 * @return Number of shards
+	 */
+	virtual unsigned Shards() const = 0;
+
+	/**
+	 * @brief Starts the workers, each runs worker(its shard) until it returns. Returns in
+	 *        the coordinator.
+	 * @param worker Work of a worker
+	 */
+	virtual void Start(std::function<void(unsigned)> const & worker) = 0;
+
+	/**
+	 * @brief Worker: sends every worker its records of the layer and receives the records
+	 *        of every worker for this one. Returns once all of them have arrived.
+	 * @param outgoing Records by owner, emptied
+	 * @param incoming Records owned by this worker, its own ones included
+	 */
+	virtual void Exchange(std::vector<std::vector<ShardRecord>> & outgoing, std::vector<ShardRecord> & incoming) = 0;
+
+	/**
+	 * @brief Worker: waits for the next message of the coordinator
+	 * @param message Message to be filled
+	 * @return false if the coordinator is gone
+	 */
+	virtual bool ReceiveControl(ShardMessage & message) = 0;
+
+	/**
+	 * @brief Worker: sends a message to the coordinator
+	 * @param message Message to be sent
+	 * @return false if the coordinator is gone
+	 */
+	virtual bool SendControl(ShardMessage const & message) = 0;
+
+	/**
+	 * @brief Coordinator: sends a message to a worker
+	 * @param shard Worker to send to
+	 * @param message Message to be sent
+	 * @return false if the worker is gone
+	 */
+	virtual bool Send(unsigned shard, ShardMessage const & message) = 0;
+
+	/**
+	 * @brief Coordinator: waits for the next message of a worker
+	 * @param shard Worker to hear from
+	 * @param message Message to be filled
+	 * @return false if the worker is gone
+	 */
+	virtual bool Receive(unsigned shard, ShardMessage & message) = 0;
+
+	/**
+	 * @brief Coordinator: closes the links and waits for the workers to exit
+	 */
+	virtual void Stop() = 0;
+};
+
+/*
+ * Workers forked from the coordinator. Every pair of workers has a pipe each way for the
+ * records, every worker a pipe each way to the coordinator. A worker polls all of its
+ * pipes while exchanging, so two workers filling each other's pipes can't get stuck.
+ * SIGPIPE should be ignored by the process (rhshard does).
+ */
+class ShardPipes : public ShardTransport {
+private:
+	unsigned shards;
+	unsigned self = 0;                       // shard of the worker process
+	std::vector<int> data = std::vector<int>();       // pipe from worker i to worker j: read end [2 * (i * shards + j)], write end one after
+	std::vector<int> control = std::vector<int>();    // per worker: coordinator to worker, then worker to coordinator (4 ends)
+	std::vector<pid_t> workers = std::vector<pid_t>();
+
+	int & DataEnd(unsigned from, unsigned to, unsigned end) { return data[2 * (from * shards + to) + end]; }
+	int & ControlEnd(unsigned shard, bool toWorker, unsigned end) { return control[4 * shard + (toWorker ? 0 : 2) + end]; }
+
+	/**
+	 * @brief Closes every pipe end, except the ones in keep
+	 * @param keep Pipe ends to leave open
+	 */
+	void CloseAllBut(std::vector<int> const & keep);
+
+public:
+	/**
+	 * @brief Constructor of the class
+	 * @param shards Number of workers
+	 */
+	explicit ShardPipes(unsigned shards) : shards(shards) {}
+
+	/**
+	 * @brief Destructor of the class, stops the workers if they are still running
+	 */
+	~ShardPipes();
+
+	ShardPipes(ShardPipes const &) = delete;
+	ShardPipes & operator=(ShardPipes const &) = delete;
+
+	unsigned Shards() const { return shards; }
+	void Start(std::function<void(unsigned)> const & worker);
+	void Exchange(std::vector<std::vector<ShardRecord>> & outgoing, std::vector<ShardRecord> & incoming);
+	bool ReceiveControl(ShardMessage & message);
+	bool SendControl(ShardMessage const & message);
+	bool Send(unsigned shard, ShardMessage const & message);
+	bool Receive(unsigned shard, ShardMessage & message);
+	void Stop();
+};
+
+/*
+ * Breadth-first search of a level over the workers of a transport. Finds a shortest
+ * solution, or proves there is none when every frontier runs dry. Needs a Packable board.
+ */
+class ShardedSearch {
+private:
+	// where a state came from, kept by its owner
+	struct Parent {
+		std::uint64_t state;
+		std::uint32_t move;
+		std::uint32_t depth;
+	};
+
+	RushHourSolver & solver;
+	ShardTransport & transport;
+	unsigned layers = 0;
+	size_t states = 0;
+	bool stopped = false;
+
+	/**
+	 * @brief Worker that owns a packed state
+	 * @param packed Packed state
+	 * @return Its shard
+	 */
+	unsigned Owner(std::uint64_t packed) const;
+
+	/**
+	 * @brief Loop of a worker process, answers the coordinator until told to stop
+	 * @param shard Shard of the worker
+	 */
+	void Work(unsigned shard);
+
+public:
+	/**
+	 * @brief Constructor of the class
+	 * @param solver Initialized solver (after InitCarLocations), searched from its current state
+	 * @param transport Links to the workers, not started yet
+	 */
+	ShardedSearch(RushHourSolver & solver, ShardTransport & transport) : solver(solver), transport(transport) {}
+
+	/**
+	 * @brief Runs the search. The deadline and the cancellation token of the solver are
+	 *        checked between the layers.
+	 * @param solution Shortest solution by car number
+	 * @return Whether it is solved or not
+	 */
+	bool Solve(MoveList & solution);
+
+	/**
+	 * @brief Getter for the number of layers expanded
+	 * @return Number of layers
+	 */
+	unsigned Layers() const { return layers; }
+
+	/**
+	 * @brief Getter for the number of states the workers own together
+	 * @return Number of states
+	 */
+	size_t States() const { return states; }
+
+	/**
+	 * @brief Whether the last search gave up because of the deadline or the token
+	 * @return Stopped or not
+	 */
+	bool Stopped() const { return stopped; }
+};
+
+#endif
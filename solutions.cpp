@@ -0,0 +1,201 @@
+/*!
+* \file solutions.cpp
+* \author Egemen Koku
+* \date 19 Oct 2026
+* \brief Impl of @b solutions.cpp
+*
+* \copyright Digipen Institute of Technology
+*
+*/
+
+#include "solutions.h"
+
+BigCount::BigCount(std::uint64_t value)
+{
+	while (value > 0) {
+		limbs.push_back(static_cast<std::uint32_t>(value));
+		value >>= 32;
+	}
+}
+
+BigCount & BigCount::operator+=(BigCount const & rhs)
+{
+	if (limbs.size() < rhs.limbs.size())
+		limbs.resize(rhs.limbs.size(), 0);
+	std::uint64_t carry = 0;
+	for (size_t i = 0; i < limbs.size() && (carry > 0 || i < rhs.limbs.size()); ++i) {
+		std::uint64_t sum = carry + limbs[i] + (i < rhs.limbs.size() ? rhs.limbs[i] : 0);
+		limbs[i] = static_cast<std::uint32_t>(sum);
+		carry = sum >> 32;
+	}
+	if (carry > 0)
+		limbs.push_back(static_cast<std::uint32_t>(carry));
+	return *this;
+}
+
+std::string BigCount::ToString() const
+{
+	if (limbs.empty())
+		return "0";
+
+	// divide by 10^9 until nothing is left, every remainder is 9 more digits
+	std::uint32_t const chunk = 1000000000;
+	std::vector<std::uint32_t> value = limbs;
+	std::string digits;
+	while (!value.empty()) {
+		std::uint64_t remainder = 0;
+		for (size_t i = value.size(); i-- > 0; ) {
+			std::uint64_t current = remainder << 32 | value[i];
+			value[i] = static_cast<std::uint32_t>(current / chunk);
+			remainder = current % chunk;
+		}
+		while (!value.empty() && value.back() == 0)
+			value.pop_back();
+		std::string part = std::to_string(remainder);
+		if (!value.empty())
+			part.insert(0, 9 - part.size(), '0');
+		digits.insert(0, part);
+	}
+	return digits;
+}
+
+OptimalSolutions::OptimalSolutions(std::string const & filename, SolveOptions const & options) : solver(filename)
+{
+	solver.InitCarLocations();
+	solver.Options(options);
+	BuildLayers();
+}
+
+void OptimalSolutions::BuildLayers()
+{
+	CarLocations start = solver.currentCarLocations;
+	states.push_back(Node{ start, 0, BigCount(1), solver.IsSolved() });
+	index.insert(std::make_pair(solver.stateHash, 0));
+	solvable = states[0].optimal;
+
+	for (size_t next = 0; next < states.size() && !solver.stopped; ++next) {
+		unsigned depth = states[next].depth;
+		// every parent of the solved layer is done, so are its counts
+		if (solvable && depth == length)
+			break;
+		if ((++solver.nodes & 4095) == 0)
+			solver.CheckLimits(depth, states.size());
+
+		solver.LoadState(states[next].locations);
+		GenerateMoves();
+		for (std::tuple<unsigned, Direction, unsigned> const & move : moves) {
+			solver.MoveCar(move);
+			size_t child = Find();
+			if (child == noState) {
+				bool solved = solver.IsSolved();
+				states.push_back(Node{ solver.currentCarLocations, depth + 1, states[next].paths, solved });
+				index.insert(std::make_pair(solver.stateHash, states.size() - 1));
+				if (solved && !solvable) {
+					solvable = true;
+					length = depth + 1;
+				}
+			}
+			else if (states[child].depth == depth + 1) {
+				// another shortest way into the child
+				states[child].paths += states[next].paths;
+			}
+			solver.MoveCar(ReverseMove(move));
+		}
+	}
+	solver.LoadState(start);
+
+	if (solver.stopped) {
+		solvable = false;
+		return;
+	}
+	for (Node const & node : states) {
+		if (node.optimal)
+			count += node.paths;
+	}
+}
+
+void OptimalSolutions::MarkOptimal()
+{
+	// deepest first, a state is on a shortest solution if one of its children one layer down is
+	for (size_t node = states.size(); node-- > 0; ) {
+		unsigned depth = states[node].depth;
+		if (depth >= length)
+			continue;
+		solver.LoadState(states[node].locations);
+		GenerateMoves();
+		for (std::tuple<unsigned, Direction, unsigned> const & move : moves) {
+			solver.MoveCar(move);
+			size_t child = Find();
+			solver.MoveCar(ReverseMove(move));
+			if (child != noState && states[child].depth == depth + 1 && states[child].optimal) {
+				states[node].optimal = true;
+				break;
+			}
+		}
+	}
+	marked = true;
+}
+
+OptimalSolutions::Frame OptimalSolutions::OptimalMoves(unsigned depth)
+{
+	Frame frame = { MoveList(), 0 };
+	GenerateMoves();
+	for (std::tuple<unsigned, Direction, unsigned> const & move : moves) {
+		solver.MoveCar(move);
+		size_t child = Find();
+		solver.MoveCar(ReverseMove(move));
+		if (child != noState && states[child].depth == depth + 1 && states[child].optimal)
+			frame.moves.push_back(move);
+	}
+	return frame;
+}
+
+bool OptimalSolutions::Next(MoveList & solution)
+{
+	if (!solvable)
+		return false;
+	if (!started) {
+		started = true;
+		if (!marked)
+			MarkOptimal();
+		solver.LoadState(states[0].locations);
+		if (length == 0) {
+			solution.clear();
+			return true;
+		}
+		stack.push_back(OptimalMoves(0));
+	}
+
+	// depth first through the optimal states, the frame of the state at depth d is stack[d]
+	while (!stack.empty()) {
+		Frame & frame = stack.back();
+		if (frame.next == frame.moves.size()) {
+			stack.pop_back();
+			if (!path.empty()) {
+				solver.MoveCar(ReverseMove(path.back()));
+				path.pop_back();
+			}
+			continue;
+		}
+
+		std::tuple<unsigned, Direction, unsigned> move = frame.moves[frame.next++];
+		solver.MoveCar(move);
+		path.push_back(move);
+		if (path.size() == length) {
+			solution = path;
+			solver.ToCarIds(solution);
+			solver.MoveCar(ReverseMove(move));
+			path.pop_back();
+			return true;
+		}
+		stack.push_back(OptimalMoves(static_cast<unsigned>(path.size())));
+	}
+	return false;
+}
+
+void OptimalSolutions::Rewind()
+{
+	started = false;
+	stack.clear();
+	path.clear();
+}
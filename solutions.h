@@ -0,0 +1,171 @@
+/*!
+* \file solutions.h
+* \author Egemen Koku
+* \date 19 Oct 2026
+* \brief Interface of @b solutions.cpp - counting and listing every shortest solution
+*
+* \copyright Digipen Institute of Technology
+*
+*/
+
+#ifndef SOLUTIONS_H
+#define SOLUTIONS_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "rushhour.h"
+
+/*
+ * Unsigned integer of any size, the number of shortest solutions grows with the factorial
+ * of the moves that can be made in any order. 32 bit limbs, least significant first.
+ */
+class BigCount {
+private:
+	std::vector<std::uint32_t> limbs = std::vector<std::uint32_t>();
+
+public:
+	/**
+	 * @brief Constructor of the class
+	 * @param value Starting value
+	 */
+	BigCount(std::uint64_t value = 0);
+
+	BigCount & operator+=(BigCount const & rhs);
+
+	bool operator==(BigCount const & rhs) const { return limbs == rhs.limbs; }
+
+	/**
+	 * @brief Whether the value is 0
+	 * @return Zero or not
+	 */
+	bool IsZero() const { return limbs.empty(); }
+
+	/**
+	 * @brief Decimal digits of the value
+	 * @return Value in base 10
+	 */
+	std::string ToString() const;
+};
+
+/*
+ * Shortest solutions of a level. Builds the breadth-first layers from the start down to
+ * the first layer with a solved state and counts the shortest paths into every state
+ * while doing it, so the number of shortest solutions comes without listing them.
+ * Next lists them one at a time, in the order the moves are generated, keeping only the
+ * solution being built. Moves are by car number.
+ */
+class OptimalSolutions {
+private:
+	// state of a layer with the number of shortest paths from the start to it
+	struct Node {
+		CarLocations locations;
+		unsigned depth;
+		BigCount paths;
+		bool optimal;                        // on a shortest solution: the solved ones at once, the rest before the first Next
+	};
+
+	// moves of a state on the solution being listed that lead one layer deeper and stay optimal
+	struct Frame {
+		MoveList moves;
+		size_t next;
+	};
+
+	RushHourSolver solver;
+	std::vector<Node> states = std::vector<Node>();
+	std::unordered_multimap<StateHash, size_t> index = std::unordered_multimap<StateHash, size_t>();
+	std::vector<std::tuple<unsigned, Direction, unsigned>> moves = std::vector<std::tuple<unsigned, Direction, unsigned>>();
+	unsigned length = 0;
+	bool solvable = false;
+	BigCount count = BigCount();
+
+	// enumeration
+	bool marked = false;                     // MarkOptimal ran
+	bool started = false;
+	std::vector<Frame> stack = std::vector<Frame>();
+	MoveList path = MoveList();
+
+	/**
+	 * @brief Breadth-first search down to the first layer with a solved state, adding the
+	 *        path counts of every parent into its children.
+	 */
+	void BuildLayers();
+
+	/**
+	 * @brief Marks the states a shortest solution goes through, from the deepest layer up
+	 */
+	void MarkOptimal();
+
+	/**
+	 * @brief Finds the current state of the solver among the layers
+	 * @return Its index in states, noState if it is not there
+	 */
+	size_t Find() const { return solver.FindState(index, states); }
+
+	/**
+	 * @brief Fills moves with every move of the current state, by car index
+	 */
+	void GenerateMoves() { moves.clear(); solver.ListMoves(moves); }
+
+	/**
+	 * @brief Frame of the current state: its moves into the next layer that stay optimal
+	 * @param depth Layer of the current state
+	 * @return Frame with its moves
+	 */
+	Frame OptimalMoves(unsigned depth);
+
+public:
+	static size_t const noState = static_cast<size_t>(-1);
+
+	/**
+	 * @brief Constructor of the class, builds the layers and counts the solutions
+	 * @param filename The name of the file of the map data
+	 * @param options Deadline and cancellation token of the layer search
+	 */
+	explicit OptimalSolutions(std::string const & filename, SolveOptions const & options = SolveOptions());
+
+	/**
+	 * @brief Whether there is a solution. false too when the deadline passed or the
+	 *        search was cancelled, see Stopped.
+	 * @return Solvable or not
+	 */
+	bool Solvable() const { return solvable; }
+
+	/**
+	 * @brief Whether the layer search gave up because of the deadline or the token
+	 * @return Stopped or not
+	 */
+	bool Stopped() const { return solver.TimedOut() || solver.Cancelled(); }
+
+	/**
+	 * @brief Moves of a shortest solution
+	 * @return Number of moves
+	 */
+	unsigned Length() const { return length; }
+
+	/**
+	 * @brief Number of distinct shortest solutions
+	 * @return Number of solutions, 0 if there is none
+	 */
+	BigCount const & Count() const { return count; }
+
+	/**
+	 * @brief Getter for the number of states in the layers
+	 * @return Number of states
+	 */
+	size_t States() const { return states.size(); }
+
+	/**
+	 * @brief Next shortest solution. The first call marks the states that are on one.
+	 * @param solution Solution to be filled, by car number
+	 * @return false once every solution was listed
+	 */
+	bool Next(MoveList & solution);
+
+	/**
+	 * @brief Starts the listing over
+	 */
+	void Rewind();
+};
+
+#endif
@@ -0,0 +1,123 @@
+/*!
+* \file trace.cpp
+* \author Egemen Koku
+* \date 19 Oct 2026
+* \brief Impl of @b trace.cpp
+*
+* \copyright Digipen Institute of Technology
+*
+*/
+
+#include "trace.h"
+#include <algorithm>
+
+// binary layout:
+// "RHT1" height width car exit   (1 byte each)
+// height*width cells             (1 byte each)
+// records: car (1 byte), direction << 6 | num positions (1 byte)
+namespace {
+	char const traceMagic[4] = { 'R', 'H', 'T', '1' };
+}
+
+TraceWriter::TraceWriter(std::ostream & os, TraceMode mode) : os(os), mode(mode)
+{
+	buffer.reserve(bufferSize + 256);
+}
+
+TraceWriter::~TraceWriter()
+{
+	Flush();
+}
+
+void TraceWriter::Start(ParkingLotBoard const & initial)
+{
+	if (mode == textTrace) {
+		board.Reset(initial);
+		return;
+	}
+
+	unsigned maxID = 0;
+	for (unsigned id : initial.cells) {
+		maxID = std::max(maxID, id);
+	}
+	if (maxID > 255 || initial.car > 255 || initial.height > 63 || initial.width > 63) {
+		throw "Board too big for binary trace";
+	}
+
+	buffer.append(traceMagic, sizeof(traceMagic));
+	buffer.push_back(static_cast<char>(initial.height));
+	buffer.push_back(static_cast<char>(initial.width));
+	buffer.push_back(static_cast<char>(initial.car));
+	buffer.push_back(static_cast<char>(initial.exitDirection));
+	for (unsigned id : initial.cells) {
+		buffer.push_back(static_cast<char>(id));
+	}
+}
+
+void TraceWriter::AppendBoard()
+{
+	// same as "os << cell << ' '" for every cell, without going through the stream
+	for (unsigned id : board.Cells()) {
+		char digits[10];
+		int count = 0;
+		do {
+			digits[count++] = static_cast<char>('0' + id % 10);
+			id /= 10;
+		} while (id != 0);
+		while (count > 0) {
+			buffer.push_back(digits[--count]);
+		}
+		buffer.push_back(' ');
+	}
+	buffer.push_back('\n');
+}
+
+void TraceWriter::Solution(MoveList const & sol)
+{
+	for (std::tuple<unsigned, Direction, unsigned> const & m : sol) {
+		Move(m);
+	}
+}
+
+void TraceWriter::Flush()
+{
+	if (!buffer.empty()) {
+		os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		buffer.clear();
+	}
+	os.flush();
+}
+
+bool DecodeTrace(std::istream & is, std::ostream & os)
+{
+	char header[8];
+	if (!is.read(header, sizeof(header)) || !std::equal(traceMagic, traceMagic + 4, header)) {
+		return false;
+	}
+
+	ParkingLotBoard initial;
+	initial.height = static_cast<unsigned char>(header[4]);
+	initial.width = static_cast<unsigned char>(header[5]);
+	initial.car = static_cast<unsigned char>(header[6]);
+	initial.exitDirection = static_cast<Direction>(header[7]);
+
+	std::string cells(initial.height * initial.width, '\0');
+	if (!is.read(&cells[0], static_cast<std::streamsize>(cells.size()))) {
+		return false;
+	}
+	for (char c : cells) {
+		initial.cells.push_back(static_cast<unsigned char>(c));
+	}
+
+	// the text writer prints exactly what a text trace would have printed
+	TraceWriter text(os, textTrace);
+	text.Start(initial);
+
+	char record[2];
+	while (is.read(record, sizeof(record))) {
+		unsigned packed = static_cast<unsigned char>(record[1]);
+		text.Move(std::make_tuple(static_cast<unsigned>(static_cast<unsigned char>(record[0])),
+		                          static_cast<Direction>(packed >> 6), packed & 63u));
+	}
+	return is.gcount() == 0;
+}
@@ -0,0 +1,110 @@
+/*!
+* \file trace.h
+* \author Egemen Koku
+* \date 19 Oct 2026
+* \brief Interface of @b trace.cpp
+*
+* \copyright Digipen Institute of Technology
+*
+*/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <ostream>
+#include <istream>
+#include <string>
+#include <tuple>
+#include "rushhour.h"
+#include "validator.h"
+
+// textTrace  - one line per move with the whole board, same as solution.all.steps.*.txt
+// binaryTrace - initial board once, then 2 bytes per move
+enum TraceMode { textTrace, binaryTrace };
+
+/*
+ * Records the moves of a solution or of a whole search (undo moves included).
+ * Everything goes through a local buffer which is written out in big chunks,
+ * nothing is flushed per move.
+ */
+class TraceWriter {
+private:
+	std::ostream & os;
+	TraceMode mode = binaryTrace;
+	SolutionValidator board;                 // text mode replays the moves to print the boards
+	std::string buffer = std::string();
+	unsigned long long records = 0;
+
+	/**
+	 * @brief Appends the current board as a single line
+	 */
+	void AppendBoard();
+
+public:
+	/**
+	 * @brief Constructor of the class
+	 * @param os Stream to write into, has to outlive the writer
+	 * @param mode Text or binary
+	 */
+	TraceWriter(std::ostream & os, TraceMode mode = binaryTrace);
+
+	/**
+	 * @brief Destructor, flushes what is left in the buffer
+	 */
+	~TraceWriter();
+
+	/**
+	 * @brief Sets the initial board. Has to be called once before the first move.
+	 * @param initial Board the moves are relative to
+	 */
+	void Start(ParkingLotBoard const & initial);
+
+	/**
+	 * @brief Records a single move
+	 * @param move Move to be recorded (car, direction, num positions)
+	 */
+	void Move(std::tuple<unsigned, Direction, unsigned> const & move)
+	{
+		++records;
+		if (mode == binaryTrace) {
+			buffer.push_back(static_cast<char>(std::get<0>(move)));
+			buffer.push_back(static_cast<char>((static_cast<unsigned>(std::get<1>(move)) << 6) | std::get<2>(move)));
+		}
+		else {
+			board.Move(move);
+			AppendBoard();
+		}
+		if (buffer.size() >= bufferSize) {
+			Flush();
+		}
+	}
+
+	/**
+	 * @brief Records every move of a solution
+	 * @param sol Solution to be recorded
+	 */
+	void Solution(MoveList const & sol);
+
+	/**
+	 * @brief Writes the buffer into the stream
+	 */
+	void Flush();
+
+	/**
+	 * @brief Getter for the number of recorded moves
+	 * @return Number of moves
+	 */
+	unsigned long long Records() const { return records; }
+
+	static size_t const bufferSize = 1 << 16;
+};
+
+/**
+ * @brief Converts a binary trace into the text format (one board per line)
+ * @param is Binary trace
+ * @param os Text output
+ * @return false if the input is not a trace
+ */
+bool DecodeTrace(std::istream & is, std::ostream & os);
+
+#endif
@@ -0,0 +1,215 @@
+/*!
+* \file validator.cpp
+* \author Egemen Koku
+* \date 19 Oct 2026
+* \brief Impl of @b validator.cpp
+*
+* \copyright Digipen Institute of Technology
+*
+*/
+
+#include "validator.h"
+#include <thread>
+#include <algorithm>
+
+char const * ValidationMessage(ValidationResult result)
+{
+	switch (result) {
+	case validSolution:   return "Solved";
+	case notSolved:       return "Car is not at the exit";
+	case unknownCar:      return "No such car in parking lot";
+	case wrongDirection:  return "Car moved against its orientation";
+	case outOfParkingLot: return "Car moved outside of parking lot";
+	case carOnTopOfCar:   return "Car moved on top of another car";
+	case badBoard:        return "Errors in board";
+	default:              return "undefined";
+	}
+}
+
+ValidationResult SolutionValidator::Reset(ParkingLotBoard const & board)
+{
+	height = board.height;
+	width = board.width;
+	car = board.car;
+	exitDirection = board.exitDirection;
+	cells = board.cells;
+
+	if (cells.size() != height * width) {
+		return badBoard;
+	}
+
+	unsigned maxID = 0;
+	for (unsigned id : cells) {
+		maxID = std::max(maxID, id);
+	}
+	cars.assign(maxID + 1, CarInfo(0, 0, 0));
+
+	// first cell of a car in row major order is its head, the rest has to line up behind it
+	for (unsigned i = 0; i < height; ++i) {
+		for (unsigned j = 0; j < width; ++j) {
+			unsigned id = cells[i * width + j];
+			if (id == 0) {
+				continue;
+			}
+			CarInfo & info = cars[id];
+			if (info.size == 0) {
+				info = CarInfo(i, j, 1, horisontal);
+			}
+			else if (info.size == 1 && info.row == i && info.column + 1 == j) {
+				++info.size;
+			}
+			else if (info.size == 1 && info.column == j && info.row + 1 == i) {
+				info.orientation = vertical;
+				++info.size;
+			}
+			else if (info.orientation == horisontal && info.row == i && info.column + info.size == j) {
+				++info.size;
+			}
+			else if (info.orientation == vertical && info.column == j && info.row + info.size == i) {
+				++info.size;
+			}
+			else {
+				return badBoard;
+			}
+		}
+	}
+
+	for (CarInfo const & info : cars) {
+		if (info.size == 1) {
+			return badBoard;
+		}
+	}
+	if (car >= cars.size() || cars[car].size == 0) {
+		return badBoard;
+	}
+	return validSolution;
+}
+
+ValidationResult SolutionValidator::Move(std::tuple<unsigned, Direction, unsigned> const & move)
+{
+	unsigned id = std::get<0>(move);
+	Direction direction = std::get<1>(move);
+	unsigned positions = std::get<2>(move);
+
+	if (id == 0 || id >= cars.size() || cars[id].size == 0) {
+		return unknownCar;
+	}
+	CarInfo & info = cars[id];
+
+	bool horizontalMove = direction == left || direction == right;
+	bool verticalMove = direction == up || direction == down;
+	if ((info.orientation == horisontal && !horizontalMove) || (info.orientation == vertical && !verticalMove)) {
+		return wrongDirection;
+	}
+
+	// bounds - compare against the free space in front of the car so nothing overflows
+	unsigned behind = horizontalMove ? info.column : info.row;
+	unsigned ahead = (horizontalMove ? width : height) - behind - info.size;
+	bool forward = direction == right || direction == down;
+	if (positions > (forward ? ahead : behind)) {
+		return outOfParkingLot;
+	}
+
+	unsigned stride = horizontalMove ? 1 : width;
+	unsigned start = info.row * width + info.column;
+
+	if (forward) {
+		// every cell swept in front of the car has to be empty
+		for (unsigned k = info.size; k < info.size + positions; ++k) {
+			if (cells[start + k * stride] != 0) {
+				return carOnTopOfCar;
+			}
+		}
+		for (unsigned k = 0; k < std::min(positions, info.size); ++k) {
+			cells[start + k * stride] = 0;
+		}
+		for (unsigned k = std::max(info.size, positions); k < info.size + positions; ++k) {
+			cells[start + k * stride] = id;
+		}
+	}
+	else {
+		for (unsigned k = 1; k <= positions; ++k) {
+			if (cells[start - k * stride] != 0) {
+				return carOnTopOfCar;
+			}
+		}
+		unsigned newStart = start - positions * stride;
+		for (unsigned k = info.size - std::min(positions, info.size); k < info.size; ++k) {
+			cells[start + k * stride] = 0;
+		}
+		for (unsigned k = 0; k < std::min(positions, info.size); ++k) {
+			cells[newStart + k * stride] = id;
+		}
+	}
+
+	if (horizontalMove) {
+		info.column = forward ? info.column + positions : info.column - positions;
+	}
+	else {
+		info.row = forward ? info.row + positions : info.row - positions;
+	}
+	return validSolution;
+}
+
+bool SolutionValidator::IsSolved() const
+{
+	CarInfo const & info = cars[car];
+	switch (exitDirection) {
+	case up:    return info.orientation == vertical   && info.row == 0;
+	case left:  return info.orientation == horisontal && info.column == 0;
+	case down:  return info.orientation == vertical   && info.row + info.size == height;
+	case right: return info.orientation == horisontal && info.column + info.size == width;
+	default:    return false;
+	}
+}
+
+ValidationReport SolutionValidator::Validate(ParkingLotBoard const & board, MoveList const & sol)
+{
+	ValidationReport report;
+	report.result = Reset(board);
+	if (report.result != validSolution) {
+		return report;
+	}
+
+	for (std::tuple<unsigned, Direction, unsigned> const & m : sol) {
+		report.result = Move(m);
+		if (report.result != validSolution) {
+			return report;
+		}
+		++report.failedMove;
+	}
+
+	report.failedMove = 0;
+	report.result = IsSolved() ? validSolution : notSolved;
+	return report;
+}
+
+void ValidateBatch(std::vector<ParkingLotBoard> const & boards, std::vector<MoveList> const & solutions,
+                   std::vector<ValidationReport> & reports, unsigned threads)
+{
+	size_t count = std::min(boards.size(), solutions.size());
+	reports.resize(count);
+
+	if (threads == 0) {
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	// not worth a thread below a few thousand pairs
+	threads = static_cast<unsigned>(std::min<size_t>(threads, count / 4096 + 1));
+
+	auto work = [&](size_t begin, size_t end) {
+		SolutionValidator validator;
+		for (size_t i = begin; i < end; ++i) {
+			reports[i] = validator.Validate(boards[i], solutions[i]);
+		}
+	};
+
+	std::vector<std::thread> workers;
+	size_t chunk = count / threads;
+	for (unsigned t = 1; t < threads; ++t) {
+		workers.push_back(std::thread(work, t * chunk, t + 1 == threads ? count : (t + 1) * chunk));
+	}
+	work(0, threads == 1 ? count : chunk);
+	for (std::thread & worker : workers) {
+		worker.join();
+	}
+}
@@ -0,0 +1,101 @@
+/*!
+* \file validator.h
+* \author Egemen Koku
+* \date 19 Oct 2026
+* \brief Interface of @b validator.cpp
+*
+* \copyright Digipen Institute of Technology
+*
+*/
+
+#ifndef VALIDATOR_H
+#define VALIDATOR_H
+
+#include <vector>
+#include <tuple>
+#include "rushhour.h"
+
+// Result of validating a move or a whole solution. No exceptions, just codes.
+enum ValidationResult {
+	validSolution,   // every move legal and the car is out
+	notSolved,       // every move legal but the car is still in
+	unknownCar,      // no car with that ID on the board
+	wrongDirection,  // horizontal car moved up/down or vice versa
+	outOfParkingLot, // car moved outside of parking lot
+	carOnTopOfCar,   // car moved on top of (or through) another car
+	badBoard         // board itself is broken (bent cars, missing main car ...)
+};
+
+/**
+ * @brief Human readable message of a validation result
+ * @param result Result to be described
+ * @return Message, same wording as the old exceptions
+ */
+char const * ValidationMessage(ValidationResult result);
+
+struct ValidationReport {
+	ValidationResult result = validSolution;
+	unsigned failedMove = 0;                 // index of the first illegal move
+};
+
+/*
+ * Replays solutions on a flat copy of the board. A move costs O(car size + positions moved)
+ * instead of a scan over the whole lot per position. Keep one instance per thread and
+ * call Reset/Validate for each board so the buffers are reused.
+ */
+class SolutionValidator {
+private:
+	unsigned height = 0;
+	unsigned width = 0;
+	unsigned car = 0;                        // car to be navigated
+	Direction exitDirection = undefined;
+	std::vector<unsigned> cells = std::vector<unsigned>(); // row major
+	std::vector<CarInfo> cars = std::vector<CarInfo>();    // indexed by car ID, size 0 means no car
+
+public:
+	/**
+	 * @brief Loads a board and builds the car table.
+	 * @param board Board to be loaded
+	 * @return badBoard if the board can't be played, validSolution otherwise
+	 */
+	ValidationResult Reset(ParkingLotBoard const & board);
+
+	/**
+	 * @brief Checks bounds and collisions of a single move and applies it when legal.
+	 * @param move Move to be applied (car, direction, num positions)
+	 * @return validSolution if the move was legal, the reason otherwise. Board is unchanged on failure.
+	 */
+	ValidationResult Move(std::tuple<unsigned, Direction, unsigned> const & move);
+
+	/**
+	 * @brief Checks whether the main car reached the exit
+	 * @return Whether solved or not
+	 */
+	bool IsSolved() const;
+
+	/**
+	 * @brief Getter for the current board
+	 * @return Cells in row major order
+	 */
+	std::vector<unsigned> const & Cells() const { return cells; }
+
+	/**
+	 * @brief Loads the board and replays the whole solution on it.
+	 * @param board Initial board
+	 * @param sol Solution to be checked
+	 * @return Result and the index of the failing move
+	 */
+	ValidationReport Validate(ParkingLotBoard const & board, MoveList const & sol);
+};
+
+/**
+ * @brief Validates many (board, solution) pairs, splitting the work between threads.
+ * @param boards Initial boards
+ * @param solutions Solutions, solutions[i] belongs to boards[i]
+ * @param reports Filled with one report per pair
+ * @param threads Number of threads, 0 means one per hardware thread
+ */
+void ValidateBatch(std::vector<ParkingLotBoard> const & boards, std::vector<MoveList> const & solutions,
+                   std::vector<ValidationReport> & reports, unsigned threads = 0);
+
+#endif